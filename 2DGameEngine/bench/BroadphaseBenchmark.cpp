@@ -0,0 +1,205 @@
+#include "../src/Collision/Broadphase.h"
+#include "../src/Collision/ColliderRecording.h"
+#include "../src/Collision/CollisionDetector.h"
+#include "../src/Threading/WorkerPool.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Replays collider recordings through every broadphase backend, on one
+// thread and on a worker pool.
+// Pass recordings made in game (debug mode, R) on the command line, or run
+// without arguments to use the generated bullet wall and dogfight scenes.
+
+struct Scene {
+	std::string name;
+	ColliderRecording recording;
+};
+
+struct Mover {
+	int entityID;
+	uint32_t category;
+	float x, y, w, h, vx, vy;
+};
+
+static ColliderRecording generateScene(std::vector<Mover> movers, int frameCount, float worldWidth) {
+
+	ColliderRecording recording;
+	std::vector<ColliderProxy> proxies;
+	const CollisionMatrix collisionMatrix = CollisionMatrix::createDefault();
+
+	for (int frame = 0; frame < frameCount; frame++) {
+
+		proxies.clear();
+
+		for (auto& mover : movers) {
+
+			mover.x += mover.vx;
+			mover.y += mover.vy;
+
+			// Wrap around so the density stays the same for the whole recording
+			if (mover.x < 0) mover.x += worldWidth;
+			if (mover.x > worldWidth) mover.x -= worldWidth;
+
+			proxies.push_back({
+				mover.entityID,
+				AABB{ mover.x, mover.y, mover.x + mover.w, mover.y + mover.h },
+				mover.category,
+				collisionMatrix.getMask(mover.category)
+			});
+		}
+
+		recording.addFrame(proxies);
+	}
+
+	return recording;
+}
+
+// 500 ships behind 1500 lasers, packed into one screen
+static ColliderRecording generateBulletWall() {
+
+	std::mt19937 random(26);
+	std::uniform_real_distribution<float> x(0.0f, 2048.0f);
+	std::uniform_real_distribution<float> y(0.0f, 688.0f);
+
+	std::vector<Mover> movers;
+
+	for (int i = 0; i < 2000; i++) {
+		bool isLaser = i >= 500;
+		movers.push_back({
+			i,
+			isLaser ? CATEGORY_PLAYER_PROJECTILE : CATEGORY_ENEMY,
+			x(random), y(random),
+			isLaser ? 10.0f : 29.0f, isLaser ? 2.0f : 32.0f,
+			isLaser ? 4.0f : -0.5f, 0.0f
+		});
+	}
+
+	return generateScene(movers, 120, 2048.0f);
+}
+
+// A few hundred AI ships and the lasers chasing them, spread over a large area
+static ColliderRecording generateDogfight() {
+
+	std::mt19937 random(27);
+	std::uniform_real_distribution<float> position(0.0f, 20000.0f);
+	std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+
+	std::vector<Mover> movers;
+
+	for (int i = 0; i < 300; i++) {
+		bool isLaser = i % 3 == 0;
+		movers.push_back({
+			i,
+			isLaser ? CATEGORY_PLAYER_PROJECTILE : CATEGORY_ENEMY,
+			position(random), position(random),
+			isLaser ? 10.0f : 29.0f, isLaser ? 2.0f : 36.0f,
+			velocity(random), velocity(random)
+		});
+	}
+
+	return generateScene(movers, 120, 20000.0f);
+}
+
+int main(int argc, char* argv[]) {
+
+	std::vector<Scene> scenes;
+
+	for (int i = 1; i < argc; i++) {
+		Scene scene{ argv[i] };
+		if (scene.recording.load(argv[i]) && !scene.recording.isEmpty()) {
+			scenes.push_back(std::move(scene));
+		}
+	}
+
+	if (argc == 1) {
+		scenes.push_back({ "bullet wall", generateBulletWall() });
+		scenes.push_back({ "dogfight", generateDogfight() });
+	}
+
+	const std::pair<BroadphaseType, std::string> backends[] = {
+		{ UNIFORM_GRID, "uniform grid" },
+		{ SWEEP_AND_PRUNE, "sweep and prune" },
+		{ DYNAMIC_AABB_TREE, "dynamic aabb tree" }
+	};
+
+	const int repetitions = 5;
+
+	WorkerPool workerPool;
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	for (const auto& scene : scenes) {
+
+		const auto& frames = scene.recording.getFrames();
+
+		std::cout << scene.name << ": " << frames.size() << " frames, " << frames.front().size() << " colliders in the first frame" << std::endl;
+
+		long long expectedOverlaps = -1;
+		unsigned long long expectedChecksum = 0;
+
+		for (const auto& backend : backends) {
+
+			// Every backend runs on one thread and then on the whole pool
+			for (WorkerPool* pool : { static_cast<WorkerPool*>(nullptr), &workerPool }) {
+
+				std::vector<CandidatePair> contacts;
+
+				long long candidates = 0;
+				long long overlapCount = 0;
+				unsigned long long checksum = 0;
+				double milliseconds = 0.0;
+
+				for (int repetition = 0; repetition < repetitions; repetition++) {
+
+					// Start every repetition from an empty broadphase
+					CollisionDetector collisionDetector(backend.first);
+					collisionDetector.setParallelThreshold(0);
+					candidates = 0;
+					overlapCount = 0;
+					checksum = 0;
+
+					for (const auto& frame : frames) {
+
+						auto start = std::chrono::steady_clock::now();
+
+						collisionDetector.detect(frame, pool, contacts);
+
+						auto end = std::chrono::steady_clock::now();
+
+						milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+
+						candidates += collisionDetector.getCandidateCount();
+						overlapCount += static_cast<long long>(contacts.size());
+
+						// Order sensitive, so the threaded runs have to match the contacts one for one
+						for (const auto& contact : contacts) {
+							checksum = checksum * 1000003ull + static_cast<unsigned long long>(contact.a) * 65599ull + static_cast<unsigned long long>(contact.b);
+						}
+					}
+				}
+
+				const double frameCount = static_cast<double>(frames.size());
+				const std::string threads = std::to_string(pool ? pool->getThreadCount() : 1) + (pool && pool->getThreadCount() > 1 ? " threads" : " thread");
+
+				std::cout << "  " << std::left << std::setw(20) << backend.second << std::setw(12) << threads << std::right
+					<< std::setw(10) << milliseconds / (frameCount * repetitions) << " ms/frame"
+					<< std::setw(12) << candidates / frameCount << " candidates/frame"
+					<< std::setw(12) << overlapCount / frameCount << " overlaps/frame" << std::endl;
+
+				if (expectedOverlaps == -1) {
+					expectedOverlaps = overlapCount;
+					expectedChecksum = checksum;
+				}
+				else if (overlapCount != expectedOverlaps || checksum != expectedChecksum) {
+					std::cout << "  " << backend.second << " on " << threads << " disagrees with " << backends[0].second << " on the contacts" << std::endl;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,371 @@
+#include "../src/ECS/ESC.h"
+#include "../src/Components/Components.h"
+#include "../src/Assets/AssetStore.h"
+#include "../src/Helpers/Colours.h"
+#include "../src/Render/FrameSnapshot.h"
+#include "../src/Render/HUDRenderer.h"
+#include "../src/Render/SoftwareRasterizer.h"
+#include "../src/System/RenderSystems.h"
+#include "../src/Threading/WorkerPool.h"
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Draws recorded scene descriptions through the game's render systems into
+// an offscreen surface, once with SDL's software renderer and once with the
+// software rasterizer, and times every stage of the frame.
+// Run from the project folder so the assets are found:
+//   ./RenderBenchmark bench/scenes/*.scene
+// SDL uses its dummy video driver, so no display or GPU is needed.
+
+const int SCREEN_WIDTH = 1024;
+const int SCREEN_HEIGHT = 720;
+// The world is drawn this far down, below the HUD, like in game
+const int MAP_OFFSET = 32;
+
+struct RenderScene {
+	std::string name;
+	int spriteCount = 0;
+	std::vector<std::string> textures;
+	int labelCount = 0;
+	// Health bars go under the first sprites, so there are never more than sprites
+	int healthBarCount = 0;
+	bool isRotating = false;
+	int frameCount = 100;
+
+	// One "<key> <value>" per line, # starts a comment
+	bool load(const std::string& filePath) {
+
+		std::ifstream file(filePath);
+
+		if (!file) {
+			Logger::LogErr("Failed To Open Render Scene at " + filePath);
+			return false;
+		}
+
+		name = filePath.substr(filePath.find_last_of("/\\") + 1);
+
+		std::string line;
+
+		while (std::getline(file, line)) {
+
+			std::istringstream values(line);
+			std::string key;
+
+			if (!(values >> key) || key[0] == '#') {
+				continue;
+			}
+
+			if (key == "sprites") {
+				values >> spriteCount;
+			}
+			else if (key == "textures") {
+				textures.clear();
+				for (std::string texture; values >> texture; ) {
+					textures.push_back(texture);
+				}
+			}
+			else if (key == "labels") {
+				values >> labelCount;
+			}
+			else if (key == "healthbars") {
+				values >> healthBarCount;
+			}
+			else if (key == "rotation") {
+				values >> isRotating;
+			}
+			else if (key == "frames") {
+				values >> frameCount;
+			}
+			else {
+				Logger::LogErr("Unknown key " + key + " in Render Scene at " + filePath);
+				return false;
+			}
+
+			if (values.fail()) {
+				Logger::LogErr("Malformed " + key + " in Render Scene at " + filePath);
+				return false;
+			}
+		}
+
+		healthBarCount = std::min(healthBarCount, spriteCount);
+		frameCount = std::max(frameCount, 1);
+
+		if (spriteCount > 0 && textures.empty()) {
+			Logger::LogErr("Render Scene without textures at " + filePath);
+			return false;
+		}
+
+		return true;
+	}
+};
+
+enum class Backend {
+	sdlSoftware,
+	softwareRasterizer
+};
+
+// Milliseconds spent in each stage over every frame
+struct StageTimes {
+	double submit = 0.0;
+	double hud = 0.0;
+	double flush = 0.0;
+};
+
+static void loadAssets(AssetStore& assetStore, SDL_Renderer* renderer) {
+	assetStore.addTexture(renderer, "player", "assets/images/playerShip2.png");
+	assetStore.addTexture(renderer, "enemyBlack", "assets/images/enemy_black.png");
+	assetStore.addTexture(renderer, "enemyBlue", "assets/images/enemy_blue.png");
+	assetStore.addTexture(renderer, "enemyAI", "assets/images/enemy_ai.png");
+	assetStore.addTexture(renderer, "playerLaser", "assets/images/player_laser.png");
+	assetStore.addTexture(renderer, "enemyLaser", "assets/images/enemyLaser.png");
+	assetStore.addTexture(renderer, "hearts", "assets/images/hearts.png");
+	assetStore.addFont(renderer, "digiBody", "assets/fonts/DS-DIGI.TTF", 12);
+	assetStore.addFont(renderer, "digiBold", "assets/fonts/DS-DIGIB.TTF", 32);
+}
+
+// Lays the scene out the same way every run, so both backends draw the same frames
+static void createEntities(Registry& registry, const AssetStore& assetStore, const RenderScene& scene) {
+
+	std::mt19937 random(50);
+	std::uniform_real_distribution<float> x(0.0f, static_cast<float>(SCREEN_WIDTH - 32));
+	std::uniform_real_distribution<float> y(0.0f, static_cast<float>(SCREEN_HEIGHT - MAP_OFFSET - 40));
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+	std::uniform_real_distribution<float> health(0.1f, 1.0f);
+
+	for (int i = 0; i < scene.spriteCount; i++) {
+
+		const std::string& assetid = scene.textures[i % scene.textures.size()];
+		const TextureInfo* texture = assetStore.getTextureInfo(assetid);
+
+		if (texture == nullptr) {
+			continue;
+		}
+
+		Entity entity = registry.createEntity(i % 2 == 0 ? enemy : projectile);
+		entity.addComponent<TransformComponent>(glm::vec2(x(random), y(random)), glm::vec2(1, 1), scene.isRotating ? angle(random) : 0.0);
+		entity.addComponent<SpriteComponent>(assetid, glm::vec2(texture->width, texture->height));
+
+		if (i < scene.healthBarCount) {
+			entity.addComponent<HealthComponent>(health(random));
+		}
+	}
+
+	for (int i = 0; i < scene.labelCount; i++) {
+		Entity label = registry.createEntity(gui);
+		const glm::vec2 position(x(random), y(random));
+		label.addComponent<TransformComponent>(position, glm::vec2(1, 1), 0.0);
+		label.addComponent<TextLabelComponent>("digiBody", position, "ENEMY " + std::to_string(i) + " +" + std::to_string(i * 10 % 500), Color::GREEN);
+	}
+
+	// The game's HUD: title, points and lives
+	Entity title = registry.createEntity(gui);
+	TextLabelComponent titleLabel("digiBold", glm::vec2(SCREEN_WIDTH * 0.5f, 0.0f), "GALACTIC ASSAULT", Color::GREEN, TextAlign::center);
+	title.addComponent<HUDComponent>(titleLabel, HUDComponent::HUDType::TITLE);
+
+	Entity points = registry.createEntity(gui);
+	TextLabelComponent pointsLabel("digiBold", glm::vec2(SCREEN_WIDTH, 0.0f), "POINTS: 00", Color::GREEN, TextAlign::right);
+	points.addComponent<HUDComponent>(pointsLabel, HUDComponent::HUDType::POINTS);
+
+	const TextureInfo* hearts = assetStore.getTextureInfo("hearts");
+
+	if (hearts != nullptr) {
+		Entity lives = registry.createEntity(gui);
+		lives.addComponent<HUDComponent>("hearts", glm::vec2(0.0f, 0.0f), glm::vec2(hearts->width, hearts->height), HUDComponent::HUDType::HEALTH);
+	}
+
+	registry.update();
+}
+
+static void turnSprites(Registry& registry) {
+	for (auto& entity : registry.getSystem<RenderSystem>().getEntities()) {
+		auto& transform = entity.getComponent<TransformComponent>();
+		transform.previousRotation = transform.rotation;
+		transform.rotation += 1.5;
+	}
+}
+
+template <typename Function>
+static double timeMilliseconds(Function function) {
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void runScene(const RenderScene& scene, Backend backend, WorkerPool& workerPool) {
+
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* renderer = target != nullptr ? SDL_CreateSoftwareRenderer(target) : nullptr;
+
+	if (renderer == nullptr) {
+		Logger::LogErr(SDL_GetError());
+		SDL_FreeSurface(target);
+		return;
+	}
+
+	const bool isRasterizer = backend == Backend::softwareRasterizer;
+
+	// Scoped so the textures are destroyed before the renderer they were made with
+	{
+		// The render systems take the store the way the game owns it
+		auto assetStore = std::make_unique<AssetStore>();
+		assetStore->keepImages(isRasterizer);
+		loadAssets(*assetStore, renderer);
+
+		Registry registry;
+		registry.addSystem<RenderSystem>();
+		registry.addSystem<TextRenderSystem>();
+		registry.addSystem<HealthBarRenderSystem>();
+		registry.addSystem<HUDRenderSystem>();
+
+		createEntities(registry, *assetStore, scene);
+
+		SoftwareRasterizer rasterizer(&workerPool);
+		rasterizer.resize(SCREEN_WIDTH, SCREEN_HEIGHT);
+		AssetStore* store = assetStore.get();
+		rasterizer.setImageLookup([store](SDL_Texture* texture) {
+			return store->getImage(texture);
+		});
+
+		FrameSnapshot frame;
+		// The rasterizer draws the HUD through its own queue, so the world counts match the SDL run
+		RenderQueue hudQueue;
+		HUDRenderer hudRenderer;
+		StageTimes times;
+		// Counts cover the world queue only, the HUD is timed on its own
+		long long drawCalls = 0;
+		long long stateChanges = 0;
+		long long commands = 0;
+
+		for (int i = 0; i < scene.frameCount; i++) {
+
+			if (scene.isRotating) {
+				turnSprites(registry);
+			}
+
+			frame.clear();
+
+			// What the simulation thread does to build a frame
+			times.submit += timeMilliseconds([&]() {
+				registry.getSystem<RenderSystem>().update(frame.world, assetStore, registry.getSystem<RenderSystem>().getEntities(), MAP_OFFSET, 1.0f);
+				registry.getSystem<HealthBarRenderSystem>().update(frame.world, registry.getSystem<HealthBarRenderSystem>().getEntities(), MAP_OFFSET, 1.0f);
+				registry.getSystem<TextRenderSystem>().update(frame.world, assetStore, registry.getSystem<TextRenderSystem>().getEntities(), MAP_OFFSET, 1.0f);
+				registry.getSystem<HUDRenderSystem>().update(frame.hud, *assetStore);
+			});
+
+			// What the render thread does with it
+			if (isRasterizer) {
+
+				rasterizer.clear(SDL_Color{ 0, 0, 0, 255 });
+
+				commands += frame.world.getCommandCount();
+
+				times.flush += timeMilliseconds([&]() {
+					frame.world.flush(rasterizer);
+				});
+
+				times.hud += timeMilliseconds([&]() {
+					hudRenderer.submit(hudQueue, *assetStore, frame.hud);
+					hudQueue.flush(rasterizer);
+				});
+			}
+			else {
+
+				SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+				SDL_RenderClear(renderer);
+
+				commands += frame.world.getCommandCount();
+
+				// SDL queues the draws, flushing makes it draw them inside the stage
+				times.flush += timeMilliseconds([&]() {
+					frame.world.flush(renderer);
+					SDL_RenderFlush(renderer);
+				});
+
+				times.hud += timeMilliseconds([&]() {
+					hudRenderer.draw(*assetStore, renderer, frame.hud);
+					SDL_RenderFlush(renderer);
+				});
+			}
+
+			drawCalls += frame.world.getDrawCallCount();
+			stateChanges += frame.world.getStateChangeCount();
+		}
+
+		hudRenderer.resetLayer();
+
+		const double frameCount = static_cast<double>(scene.frameCount);
+		const double total = times.submit + times.hud + times.flush;
+		// Submitting is simulation work, throughput is what the render thread gets through
+		const double renderTime = times.flush + times.hud;
+		const std::string backendName = isRasterizer
+			? "rasterizer " + std::to_string(workerPool.getThreadCount()) + (workerPool.getThreadCount() > 1 ? " threads" : " thread")
+			: "sdl software";
+
+		std::cout << "  " << std::left << std::setw(24) << backendName << std::right
+			<< std::setw(9) << times.submit / frameCount << " submit"
+			<< std::setw(9) << times.flush / frameCount << " flush"
+			<< std::setw(9) << times.hud / frameCount << " hud"
+			<< std::setw(9) << total / frameCount << " ms/frame"
+			<< std::setw(8) << drawCalls / frameCount << " draws"
+			<< std::setw(8) << stateChanges / frameCount << " switches"
+			<< std::setw(12) << (renderTime > 0.0 ? commands / renderTime : 0.0) << " commands/ms" << std::endl;
+	}
+
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+}
+
+int main(int argc, char* argv[]) {
+
+	if (argc == 1) {
+		std::cout << "Usage: RenderBenchmark <scene file>..." << std::endl;
+		return 1;
+	}
+
+	// No display is needed, rendering goes into a surface
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+	if (SDL_Init(SDL_INIT_VIDEO) != 0 || TTF_Init() != 0) {
+		Logger::LogErr(SDL_GetError());
+		return 1;
+	}
+
+	std::vector<RenderScene> scenes;
+
+	for (int i = 1; i < argc; i++) {
+		RenderScene scene;
+		if (scene.load(argv[i])) {
+			scenes.push_back(std::move(scene));
+		}
+	}
+
+	WorkerPool workerPool;
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	for (const auto& scene : scenes) {
+
+		std::cout << scene.name << ": " << scene.frameCount << " frames, "
+			<< scene.spriteCount << " sprites over " << scene.textures.size() << " textures, "
+			<< scene.labelCount << " labels, " << scene.healthBarCount << " health bars"
+			<< (scene.isRotating ? ", rotating" : "") << std::endl;
+
+		runScene(scene, Backend::sdlSoftware, workerPool);
+		runScene(scene, Backend::softwareRasterizer, workerPool);
+	}
+
+	TTF_Quit();
+	SDL_Quit();
+
+	return 0;
+}
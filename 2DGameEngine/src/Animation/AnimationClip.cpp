@@ -0,0 +1,40 @@
+#include "AnimationClip.h"
+#include <algorithm>
+
+AnimationClip AnimationClip::fromStrip(int frameWidth, int frameHeight, int frameCount, int frameRate, int loopCount) {
+
+	AnimationClip clip;
+	clip.loopCount = loopCount;
+
+	if (frameCount <= 0 || frameRate <= 0) {
+		return clip;
+	}
+
+	for (int i = 0; i < frameCount; i++) {
+		clip.frames.push_back(SDL_Rect{ i * frameWidth, 0, frameWidth, frameHeight });
+		// Rounded per frame end, so the cycle is exactly frameCount / frameRate seconds
+		clip.frameEnds.push_back(std::max(i + 1, (i + 1) * 1000 / frameRate));
+	}
+
+	return clip;
+}
+
+int AnimationClip::getDuration() const {
+	return frameEnds.empty() ? 0 : frameEnds.back();
+}
+
+int AnimationClip::getFrameAt(int time) const {
+
+	// The first frame that has not ended yet
+	auto frameEnd = std::upper_bound(frameEnds.begin(), frameEnds.end(), time);
+
+	if (frameEnd == frameEnds.end()) {
+		return static_cast<int>(frameEnds.size()) - 1;
+	}
+
+	return static_cast<int>(frameEnd - frameEnds.begin());
+}
+
+bool AnimationClip::isEmpty() const {
+	return frames.empty();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+/// <summary>
+/// A sprite animation worked out once at load. Every frame has its source
+/// rectangle and the time it ends at, so playback only has to find the
+/// frame for a time instead of doing the arithmetic on every tick
+/// </summary>
+struct AnimationClip {
+
+	std::vector<SDL_Rect> frames;
+	// Milliseconds from the start of a cycle to the end of each frame
+	std::vector<int> frameEnds;
+	// Cycles to play before the clip completes, 0 loops forever
+	int loopCount = 1;
+
+	// A horizontal strip of frameCount equal frames shown frameRate times a second
+	static AnimationClip fromStrip(int frameWidth, int frameHeight, int frameCount, int frameRate, int loopCount);
+
+	// Milliseconds one cycle takes
+	int getDuration() const;
+
+	// The frame showing at time milliseconds into a cycle
+	int getFrameAt(int time) const;
+
+	bool isEmpty() const;
+};
@@ -1,6 +1,8 @@
 #include "./AssetStore.h"
 #include "../Logger/Logger.h"
 #include <SDL_image.h>
+#include <algorithm>
+#include <utility>
 
 AssetStore::AssetStore()
 {
@@ -13,47 +15,287 @@ AssetStore::~AssetStore() {
 }
 
 void AssetStore::addTexture(SDL_Renderer* renderer, const std::string& assetid, const std::string& filePath) {
+
+	if (textureIDs.find(assetid) != textureIDs.end()) {
+		Logger::LogErr("Texture already loaded with id: " + assetid);
+		return;
+	}
+
 	SDL_Surface* surface = IMG_Load(filePath.c_str());
 
 	if (surface == NULL) {
 		Logger::LogErr(SDL_GetError());
+		return;
 	}
 
-	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-	
-	if (texture == NULL) {
+	// Convert first so the alpha is always the fourth byte of every pixel
+	SDL_Surface* rgbaSurface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+	SDL_FreeSurface(surface);
+
+	if (rgbaSurface == NULL) {
 		Logger::LogErr(SDL_GetError());
+		return;
 	}
 
-	SDL_FreeSurface(surface);
+	addSpriteMask(assetid, rgbaSurface);
+
+	TextureInfo textureInfo;
+
+	// Big images like the background would only crowd the atlas, they keep their own texture
+	const bool isSmall = rgbaSurface->w <= ATLAS_MAX_IMAGE_SIZE && rgbaSurface->h <= ATLAS_MAX_IMAGE_SIZE;
+
+	if (!isSmall || !addToAtlas(renderer, rgbaSurface, textureInfo)) {
 
-	textures.emplace(assetid, texture);
+		SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, rgbaSurface);
+
+		if (texture == NULL) {
+			Logger::LogErr(SDL_GetError());
+			SDL_FreeSurface(rgbaSurface);
+			return;
+		}
+
+		textures.push_back(texture);
+		keepImage(texture, rgbaSurface);
+
+		textureInfo.texture = texture;
+		textureInfo.width = rgbaSurface->w;
+		textureInfo.height = rgbaSurface->h;
+		textureInfo.textureWidth = rgbaSurface->w;
+		textureInfo.textureHeight = rgbaSurface->h;
+	}
+
+	SDL_FreeSurface(rgbaSurface);
+
+	textureIDs.emplace(assetid, static_cast<int>(textureInfos.size()));
+	textureInfos.push_back(textureInfo);
 
 	Logger::Log("New Texture created with id: " + assetid);
 }
 
-SDL_Texture* AssetStore::getTexture(const std::string& assetid) {
-	return textures[assetid];
+bool AssetStore::addAtlasPage(SDL_Renderer* renderer) {
+
+	int size = ATLAS_PAGE_SIZE;
+
+	SDL_RendererInfo rendererInfo;
+
+	// A max size of 0 means the renderer has no limit
+	if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0) {
+		if (rendererInfo.max_texture_width > 0) {
+			size = std::min(size, rendererInfo.max_texture_width);
+		}
+		if (rendererInfo.max_texture_height > 0) {
+			size = std::min(size, rendererInfo.max_texture_height);
+		}
+	}
+
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
+
+	if (texture == NULL) {
+		Logger::LogErr(SDL_GetError());
+		return false;
+	}
+
+	// A new texture holds whatever the driver left there, the gaps between images have to be clear
+	std::vector<uint32_t> clearPixels(static_cast<size_t>(size) * size, 0);
+
+	if (SDL_UpdateTexture(texture, NULL, clearPixels.data(), size * 4) != 0) {
+		Logger::LogErr(SDL_GetError());
+	}
+
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	textures.push_back(texture);
+	atlasPages.push_back({ texture, SkylinePacker(size, size) });
+
+	if (isKeepingImages) {
+		images.emplace(texture, SoftwareImage(size, size));
+	}
+
+	Logger::Log("New Atlas page created with size: " + std::to_string(size));
+
+	return true;
+}
+
+bool AssetStore::addToAtlas(SDL_Renderer* renderer, SDL_Surface* rgbaSurface, TextureInfo& textureInfo) {
+
+	const int paddedWidth = rgbaSurface->w + 2 * ATLAS_PADDING;
+	const int paddedHeight = rgbaSurface->h + 2 * ATLAS_PADDING;
+
+	int x = 0;
+	int y = 0;
+	AtlasPage* page = nullptr;
+
+	for (auto& atlasPage : atlasPages) {
+		if (atlasPage.packer.pack(paddedWidth, paddedHeight, x, y)) {
+			page = &atlasPage;
+			break;
+		}
+	}
+
+	if (page == nullptr) {
+
+		if (!addAtlasPage(renderer) || !atlasPages.back().packer.pack(paddedWidth, paddedHeight, x, y)) {
+			return false;
+		}
+
+		page = &atlasPages.back();
+	}
+
+	const SDL_Rect region{ x + ATLAS_PADDING, y + ATLAS_PADDING, rgbaSurface->w, rgbaSurface->h };
+
+	SDL_LockSurface(rgbaSurface);
+	const int result = SDL_UpdateTexture(page->texture, &region, rgbaSurface->pixels, rgbaSurface->pitch);
+	SDL_UnlockSurface(rgbaSurface);
+
+	if (result != 0) {
+		Logger::LogErr(SDL_GetError());
+		return false;
+	}
+
+	if (isKeepingImages) {
+		SDL_LockSurface(rgbaSurface);
+		images[page->texture].copy(SoftwareImage::fromRGBA(static_cast<const uint8_t*>(rgbaSurface->pixels), rgbaSurface->w, rgbaSurface->h, rgbaSurface->pitch), region.x, region.y);
+		SDL_UnlockSurface(rgbaSurface);
+	}
+
+	textureInfo.texture = page->texture;
+	textureInfo.x = region.x;
+	textureInfo.y = region.y;
+	textureInfo.width = region.w;
+	textureInfo.height = region.h;
+	textureInfo.textureWidth = page->packer.getWidth();
+	textureInfo.textureHeight = page->packer.getHeight();
+
+	return true;
+}
+
+int AssetStore::getTextureID(const std::string& assetid) const {
+
+	auto textureID = textureIDs.find(assetid);
+
+	if (textureID == textureIDs.end()) {
+		return -1;
+	}
+
+	return textureID->second;
+}
+
+const TextureInfo& AssetStore::getTextureInfo(int textureID) const {
+	return textureInfos[textureID];
+}
+
+const TextureInfo* AssetStore::getTextureInfo(const std::string& assetid) const {
+
+	const int textureID = getTextureID(assetid);
+
+	if (textureID == -1) {
+		return nullptr;
+	}
+
+	return &textureInfos[textureID];
+}
+
+void AssetStore::addSpriteMask(const std::string& assetid, SDL_Surface* rgbaSurface) {
+
+	SDL_LockSurface(rgbaSurface);
+	spriteMasks.addTexture(assetid, SpriteMask::fromRGBA(static_cast<const uint8_t*>(rgbaSurface->pixels), rgbaSurface->w, rgbaSurface->h, rgbaSurface->pitch));
+	SDL_UnlockSurface(rgbaSurface);
+}
+
+SpriteMaskCache& AssetStore::getSpriteMasks() {
+	return spriteMasks;
+}
+
+void AssetStore::keepImages(bool isKeepingImages) {
+	this->isKeepingImages = isKeepingImages;
+}
+
+void AssetStore::keepImage(SDL_Texture* texture, SDL_Surface* rgbaSurface) {
+
+	if (!isKeepingImages) {
+		return;
+	}
+
+	SDL_LockSurface(rgbaSurface);
+	images[texture] = SoftwareImage::fromRGBA(static_cast<const uint8_t*>(rgbaSurface->pixels), rgbaSurface->w, rgbaSurface->h, rgbaSurface->pitch);
+	SDL_UnlockSurface(rgbaSurface);
+}
+
+const SoftwareImage* AssetStore::getImage(const SDL_Texture* texture) const {
+
+	auto image = images.find(texture);
+
+	if (image == images.end()) {
+		return nullptr;
+	}
+
+	return &image->second;
 }
 
 void AssetStore::clearAssets() {
 	for (auto texture : textures) {
-		SDL_DestroyTexture(texture.second);
+		SDL_DestroyTexture(texture);
 	}
 	textures.clear();
+	atlasPages.clear();
+	textureIDs.clear();
+	textureInfos.clear();
+	spriteMasks.clear();
+	images.clear();
 	
 	for (auto font : fonts) {
 		TTF_CloseFont(font.second);
 	}
 	fonts.clear();
+
+	for (auto& glyphAtlas : glyphAtlases) {
+		glyphAtlas.second.destroy();
+	}
+	glyphAtlases.clear();
 	for (auto sound : sounds) {
 		Mix_FreeChunk(sound.second);
 	}
 	sounds.clear();
 }
 
-void AssetStore::addFont(const std::string fontid, const std::string filePath, int fontSize) {
-	fonts.emplace(fontid, TTF_OpenFont(filePath.c_str(), fontSize));
+void AssetStore::addFont(SDL_Renderer* renderer, const std::string fontid, const std::string filePath, int fontSize) {
+
+	TTF_Font* font = TTF_OpenFont(filePath.c_str(), fontSize);
+
+	if (font == nullptr) {
+		Logger::LogErr("Failed To Load Font at " + filePath);
+	}
+
+	fonts.emplace(fontid, font);
+
+	if (font == nullptr) {
+		return;
+	}
+
+	auto& glyphAtlas = glyphAtlases[fontid];
+	SoftwareImage image;
+
+	// Rasterise every glyph once, text is drawn from the atlas from then on
+	if (!glyphAtlas.build(renderer, font, isKeepingImages ? &image : nullptr)) {
+		Logger::LogErr("Failed To Build Glyph Atlas for " + fontid);
+		return;
+	}
+
+	if (isKeepingImages) {
+		images[glyphAtlas.getTexture()] = std::move(image);
+	}
+}
+
+const GlyphAtlas* AssetStore::getGlyphAtlas(const std::string& fontid) const {
+
+	auto glyphAtlas = glyphAtlases.find(fontid);
+
+	if (glyphAtlas == glyphAtlases.end()) {
+		return nullptr;
+	}
+
+	return &glyphAtlas->second;
 }
 
 TTF_Font* AssetStore::getFont(const std::string fontid) {
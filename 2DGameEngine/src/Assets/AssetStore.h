@@ -2,20 +2,71 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <SDL.h>
 #include <vector>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#include "../Collision/SpriteMask.h"
+#include "GlyphAtlas.h"
+#include "SkylinePacker.h"
+#include "SoftwareImage.h"
+
+/// <summary>
+/// Where a loaded image lives, looked up by texture id so drawing needs
+/// neither a string lookup nor a texture query. Small images share an
+/// atlas texture, so the image is the width by height rectangle at x, y
+/// </summary>
+struct TextureInfo {
+	SDL_Texture* texture = nullptr;
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+	int textureWidth = 0;
+	int textureHeight = 0;
+
+	// srcRect is relative to the image, the result to the texture
+	SDL_Rect getSource(const SDL_Rect& srcRect) const {
+		return SDL_Rect{ srcRect.x + x, srcRect.y + y, srcRect.w, srcRect.h };
+	}
+};
 
 class AssetStore {
 
 private:
 
-	std::map<std::string, SDL_Texture*> textures;
+	struct AtlasPage {
+		SDL_Texture* texture;
+		SkylinePacker packer;
+	};
+
+	// Images up to this size are packed into shared pages, so sprites batch across them
+	static constexpr int ATLAS_PAGE_SIZE = 1024;
+	static constexpr int ATLAS_MAX_IMAGE_SIZE = 256;
+	// Transparent border around every packed image so filtering never reads a neighbour
+	static constexpr int ATLAS_PADDING = 1;
+
+	// Every texture the store owns, atlas pages included
+	std::vector<SDL_Texture*> textures;
+	std::vector<AtlasPage> atlasPages;
+	std::map<std::string, int> textureIDs;
+	std::vector<TextureInfo> textureInfos;
 	std::map<std::string, TTF_Font*> fonts;
+	std::map<std::string, GlyphAtlas> glyphAtlases;
 	std::map<std::string, Mix_Chunk*> sounds;
 	std::map<std::string, Mix_Music*> music;
 	std::vector<int> textureMap;
+	SpriteMaskCache spriteMasks;
+
+	// Copies of every texture's pixels, kept only for the software rasterizer
+	bool isKeepingImages = false;
+	std::unordered_map<const SDL_Texture*, SoftwareImage> images;
+
+	void keepImage(SDL_Texture* texture, SDL_Surface* rgbaSurface);
+	void addSpriteMask(const std::string& assetid, SDL_Surface* rgbaSurface);
+	bool addToAtlas(SDL_Renderer* renderer, SDL_Surface* rgbaSurface, TextureInfo& textureInfo);
+	bool addAtlasPage(SDL_Renderer* renderer);
 
 public:
 	AssetStore();
@@ -23,10 +74,21 @@ public:
 
 	void clearAssets();
 	void addTexture(SDL_Renderer* renderer, const std::string& assetid, const std::string& filePath);
-	SDL_Texture* getTexture(const std::string& assetid);
+	// -1 when no texture was loaded with that id
+	int getTextureID(const std::string& assetid) const;
+	const TextureInfo& getTextureInfo(int textureID) const;
+	// nullptr when no texture was loaded with that id
+	const TextureInfo* getTextureInfo(const std::string& assetid) const;
+	SpriteMaskCache& getSpriteMasks();
+
+	// Keep a copy of the pixels of everything loaded from now on, so it can be drawn in software
+	void keepImages(bool isKeepingImages);
+	// nullptr when the texture has no copy
+	const SoftwareImage* getImage(const SDL_Texture* texture) const;
 
-	void addFont(const std::string fontid, const std::string filePath, int fontSize);
+	void addFont(SDL_Renderer* renderer, const std::string fontid, const std::string filePath, int fontSize);
 	TTF_Font* getFont(const std::string fontid);
+	const GlyphAtlas* getGlyphAtlas(const std::string& fontid) const;
 
 	void addSound(const std::string assetid, const std::string filePath);
 	Mix_Chunk* getSoundFX(const std::string assetid);
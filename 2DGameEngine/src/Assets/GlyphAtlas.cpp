@@ -0,0 +1,200 @@
+#include "GlyphAtlas.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+
+int GlyphAtlas::indexOf(char character) {
+
+	if (character < FIRST_CHARACTER || character > LAST_CHARACTER) {
+		return -1;
+	}
+
+	return character - FIRST_CHARACTER;
+}
+
+bool GlyphAtlas::build(SDL_Renderer* renderer, TTF_Font* font, SoftwareImage* image) {
+
+	destroy();
+
+	if (font == nullptr) {
+		return false;
+	}
+
+	const SDL_Color white = { 255, 255, 255, 255 };
+
+	std::vector<SDL_Surface*> surfaces(CHARACTER_COUNT, nullptr);
+	glyphs.assign(CHARACTER_COUNT, Glyph());
+
+	lineHeight = TTF_FontHeight(font);
+
+	// Shelf packing: glyphs go left to right in rows as tall as a line, a new row when one is full
+	const int atlasWidth = 256;
+	const int padding = 1;
+	int x = 0;
+	int y = 0;
+
+	for (int i = 0; i < CHARACTER_COUNT; i++) {
+
+		const Uint16 character = static_cast<Uint16>(FIRST_CHARACTER + i);
+
+		int minX, maxX, minY, maxY, advance;
+
+		if (TTF_GlyphMetrics(font, character, &minX, &maxX, &minY, &maxY, &advance) != 0) {
+			continue;
+		}
+
+		glyphs[i].advance = advance;
+
+		SDL_Surface* surface = TTF_RenderGlyph_Blended(font, character, white);
+
+		if (surface == nullptr) {
+			continue;
+		}
+
+		if (x + surface->w > atlasWidth) {
+			x = 0;
+			y += lineHeight + padding;
+		}
+
+		glyphs[i].source = { x, y, surface->w, surface->h };
+		surfaces[i] = surface;
+
+		x += surface->w + padding;
+	}
+
+	width = atlasWidth;
+	height = y + lineHeight;
+
+	SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+
+	if (atlas == nullptr) {
+		Logger::LogErr(SDL_GetError());
+	}
+
+	for (int i = 0; i < CHARACTER_COUNT; i++) {
+
+		if (surfaces[i] == nullptr) {
+			continue;
+		}
+
+		if (atlas != nullptr) {
+			// Copy the alpha as it is instead of blending it onto the empty atlas
+			SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(surfaces[i], NULL, atlas, &glyphs[i].source);
+		}
+
+		SDL_FreeSurface(surfaces[i]);
+	}
+
+	if (atlas == nullptr) {
+		return false;
+	}
+
+	if (image != nullptr) {
+		SDL_LockSurface(atlas);
+		*image = SoftwareImage::fromRGBA(static_cast<const uint8_t*>(atlas->pixels), atlas->w, atlas->h, atlas->pitch);
+		SDL_UnlockSurface(atlas);
+	}
+
+	texture = SDL_CreateTextureFromSurface(renderer, atlas);
+	SDL_FreeSurface(atlas);
+
+	if (texture == nullptr) {
+		Logger::LogErr(SDL_GetError());
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	kerning.assign(CHARACTER_COUNT * CHARACTER_COUNT, 0);
+
+	if (TTF_GetFontKerning(font)) {
+		for (int previous = 0; previous < CHARACTER_COUNT; previous++) {
+			for (int current = 0; current < CHARACTER_COUNT; current++) {
+				kerning[previous * CHARACTER_COUNT + current] = TTF_GetFontKerningSizeGlyphs(
+					font,
+					static_cast<Uint16>(FIRST_CHARACTER + previous),
+					static_cast<Uint16>(FIRST_CHARACTER + current));
+			}
+		}
+	}
+
+	return true;
+}
+
+void GlyphAtlas::destroy() {
+
+	if (texture != nullptr) {
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+
+	glyphs.clear();
+	kerning.clear();
+}
+
+const Glyph* GlyphAtlas::getGlyph(char character) const {
+
+	const int index = indexOf(character);
+
+	if (index == -1 || glyphs.empty()) {
+		return nullptr;
+	}
+
+	return &glyphs[index];
+}
+
+int GlyphAtlas::getKerning(char previous, char current) const {
+
+	const int previousIndex = indexOf(previous);
+	const int currentIndex = indexOf(current);
+
+	if (previousIndex == -1 || currentIndex == -1 || kerning.empty()) {
+		return 0;
+	}
+
+	return kerning[previousIndex * CHARACTER_COUNT + currentIndex];
+}
+
+int GlyphAtlas::measure(const std::string& text) const {
+	return measure(text.data(), text.size());
+}
+
+int GlyphAtlas::measure(const char* text, size_t length) const {
+
+	int penX = 0;
+	int right = 0;
+	char previous = 0;
+
+	for (size_t i = 0; i < length; i++) {
+
+		const char character = text[i];
+		const Glyph* glyph = getGlyph(character);
+
+		if (glyph == nullptr) {
+			continue;
+		}
+
+		penX += getKerning(previous, character);
+		right = std::max(right, penX + glyph->source.w);
+		penX += glyph->advance;
+		previous = character;
+	}
+
+	return std::max(right, penX);
+}
+
+int GlyphAtlas::getLineHeight() const {
+	return lineHeight;
+}
+
+int GlyphAtlas::getWidth() const {
+	return width;
+}
+
+int GlyphAtlas::getHeight() const {
+	return height;
+}
+
+SDL_Texture* GlyphAtlas::getTexture() const {
+	return texture;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include "SoftwareImage.h"
+#include <vector>
+
+/// <summary>
+/// Where a glyph sits in the atlas. The rectangle is the glyph as TTF renders
+/// it on its own: advance wide or wider, and one line tall
+/// </summary>
+struct Glyph {
+	SDL_Rect source{ 0, 0, 0, 0 };
+	int advance = 0;
+};
+
+/// <summary>
+/// Every printable ASCII glyph of one font at one size, rendered white into a
+/// single texture when the font is loaded. Text is then drawn as quads cut
+/// from the atlas and tinted through the vertex colour
+/// </summary>
+class GlyphAtlas {
+
+private:
+
+	static const char FIRST_CHARACTER = 32;
+	static const char LAST_CHARACTER = 126;
+	static const int CHARACTER_COUNT = LAST_CHARACTER - FIRST_CHARACTER + 1;
+
+	SDL_Texture* texture = nullptr;
+	int width = 0;
+	int height = 0;
+	int lineHeight = 0;
+
+	std::vector<Glyph> glyphs;
+	// Kerning between every pair of characters, indexed [previous * CHARACTER_COUNT + current]
+	std::vector<int> kerning;
+
+	static int indexOf(char character);
+
+public:
+
+	GlyphAtlas() = default;
+
+	// image, when given, gets a copy of the atlas pixels for the software rasterizer
+	bool build(SDL_Renderer* renderer, TTF_Font* font, SoftwareImage* image = nullptr);
+	void destroy();
+
+	// Null for characters the atlas does not hold
+	const Glyph* getGlyph(char character) const;
+	int getKerning(char previous, char current) const;
+
+	// Width of a line of text, the same as laying it out glyph by glyph
+	int measure(const std::string& text) const;
+	int measure(const char* text, size_t length) const;
+
+	int getLineHeight() const;
+	int getWidth() const;
+	int getHeight() const;
+	SDL_Texture* getTexture() const;
+};
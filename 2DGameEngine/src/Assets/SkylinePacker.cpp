@@ -0,0 +1,110 @@
+#include "SkylinePacker.h"
+#include <algorithm>
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height) {
+	skyline.push_back({ 0, 0, width });
+}
+
+int SkylinePacker::fitAt(int index, int rectWidth, int rectHeight) const {
+
+	if (skyline[index].x + rectWidth > width) {
+		return -1;
+	}
+
+	// The rectangle rests on the highest segment it spans
+	int y = 0;
+	int remaining = rectWidth;
+
+	for (int i = index; remaining > 0; i++) {
+		y = std::max(y, skyline[i].y);
+		remaining -= skyline[i].width;
+	}
+
+	if (y + rectHeight > height) {
+		return -1;
+	}
+
+	return y;
+}
+
+bool SkylinePacker::pack(int rectWidth, int rectHeight, int& x, int& y) {
+
+	if (rectWidth <= 0 || rectHeight <= 0) {
+		return false;
+	}
+
+	int bestIndex = -1;
+	int bestBottom = 0;
+	int bestWidth = 0;
+
+	for (int i = 0; i < static_cast<int>(skyline.size()); i++) {
+
+		const int top = fitAt(i, rectWidth, rectHeight);
+
+		if (top == -1) {
+			continue;
+		}
+
+		// Lowest bottom edge first, the narrower segment wastes less on a tie
+		const int bottom = top + rectHeight;
+
+		if (bestIndex == -1 || bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth)) {
+			bestIndex = i;
+			bestBottom = bottom;
+			bestWidth = skyline[i].width;
+		}
+	}
+
+	if (bestIndex == -1) {
+		return false;
+	}
+
+	x = skyline[bestIndex].x;
+	y = bestBottom - rectHeight;
+
+	// The new segment covers the rectangle, the ones it shadows shrink or go
+	skyline.insert(skyline.begin() + bestIndex, { x, bestBottom, rectWidth });
+
+	const int right = x + rectWidth;
+
+	for (int i = bestIndex + 1; i < static_cast<int>(skyline.size()); ) {
+
+		Segment& segment = skyline[i];
+
+		if (segment.x >= right) {
+			break;
+		}
+
+		const int segmentRight = segment.x + segment.width;
+
+		if (segmentRight <= right) {
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
+
+		segment.width = segmentRight - right;
+		segment.x = right;
+		break;
+	}
+
+	// Neighbours at the same height become one segment
+	for (int i = 0; i + 1 < static_cast<int>(skyline.size()); ) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else {
+			i++;
+		}
+	}
+
+	return true;
+}
+
+int SkylinePacker::getWidth() const {
+	return width;
+}
+
+int SkylinePacker::getHeight() const {
+	return height;
+}
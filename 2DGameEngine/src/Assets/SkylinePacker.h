@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+/// <summary>
+/// Packs rectangles into a fixed size page with the bottom left skyline rule.
+/// The skyline is the top edge of everything placed so far, and every new
+/// rectangle goes where it keeps that edge lowest
+/// </summary>
+class SkylinePacker {
+
+private:
+
+	// A horizontal piece of the skyline starting at x, everything below y is taken
+	struct Segment {
+		int x;
+		int y;
+		int width;
+	};
+
+	int width = 0;
+	int height = 0;
+	std::vector<Segment> skyline;
+
+	// Top of a width wide rectangle resting on the skyline from segment index, -1 when it does not fit
+	int fitAt(int index, int rectWidth, int rectHeight) const;
+
+public:
+
+	SkylinePacker() = default;
+	SkylinePacker(int width, int height);
+
+	// Finds room for a rectangle and reserves it. Returns false when the page is too full
+	bool pack(int rectWidth, int rectHeight, int& x, int& y);
+
+	int getWidth() const;
+	int getHeight() const;
+};
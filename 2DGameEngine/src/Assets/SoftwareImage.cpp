@@ -0,0 +1,67 @@
+#include "SoftwareImage.h"
+#include <algorithm>
+
+SoftwareImage::SoftwareImage(int width, int height) :
+	width(std::max(width, 0)),
+	height(std::max(height, 0)),
+	pixels(static_cast<size_t>(std::max(width, 0)) * std::max(height, 0), 0) {
+}
+
+SoftwareImage SoftwareImage::fromRGBA(const uint8_t* pixels, int width, int height, int pitch) {
+
+	SoftwareImage image(width, height);
+
+	for (int y = 0; y < height; y++) {
+
+		const uint8_t* row = pixels + static_cast<size_t>(y) * pitch;
+		uint32_t* out = image.pixels.data() + static_cast<size_t>(y) * width;
+
+		for (int x = 0; x < width; x++) {
+
+			const uint32_t alpha = row[x * 4 + 3];
+			// Rounded x * alpha / 255
+			auto premultiply = [alpha](uint32_t channel) {
+				const uint32_t product = channel * alpha + 128;
+				return (product + (product >> 8)) >> 8;
+			};
+
+			out[x] = (alpha << 24) |
+				(premultiply(row[x * 4]) << 16) |
+				(premultiply(row[x * 4 + 1]) << 8) |
+				premultiply(row[x * 4 + 2]);
+		}
+	}
+
+	return image;
+}
+
+void SoftwareImage::copy(const SoftwareImage& image, int x, int y) {
+
+	const int firstX = std::max(0, -x);
+	const int firstY = std::max(0, -y);
+	const int lastX = std::min(image.width, width - x);
+	const int lastY = std::min(image.height, height - y);
+
+	if (lastX <= firstX) {
+		return;
+	}
+
+	for (int row = firstY; row < lastY; row++) {
+		std::copy(
+			image.pixels.begin() + static_cast<size_t>(row) * image.width + firstX,
+			image.pixels.begin() + static_cast<size_t>(row) * image.width + lastX,
+			pixels.begin() + static_cast<size_t>(row + y) * width + x + firstX);
+	}
+}
+
+int SoftwareImage::getWidth() const {
+	return width;
+}
+
+int SoftwareImage::getHeight() const {
+	return height;
+}
+
+const uint32_t* SoftwareImage::getPixels() const {
+	return pixels.data();
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// A copy of an image in memory for the software rasterizer to sample,
+/// since the pixels of an SDL texture cannot be read back. Pixels are
+/// 0xAARRGGBB with the colour already multiplied by the alpha
+/// </summary>
+class SoftwareImage {
+
+private:
+
+	int width = 0;
+	int height = 0;
+	std::vector<uint32_t> pixels;
+
+public:
+
+	SoftwareImage() = default;
+	// Fully transparent
+	SoftwareImage(int width, int height);
+
+	// pixels are 32 bit RGBA
+	static SoftwareImage fromRGBA(const uint8_t* pixels, int width, int height, int pitch);
+
+	// Copies image in with its top left at x, y, clipped to this image
+	void copy(const SoftwareImage& image, int x, int y);
+
+	int getWidth() const;
+	int getHeight() const;
+	const uint32_t* getPixels() const;
+};
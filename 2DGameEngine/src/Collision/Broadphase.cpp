@@ -0,0 +1,17 @@
+#include "Broadphase.h"
+#include "UniformGridBroadphase.h"
+#include "SweepAndPruneBroadphase.h"
+#include "DynamicAABBTreeBroadphase.h"
+
+std::unique_ptr<IBroadphase> createBroadphase(BroadphaseType type) {
+
+	switch (type) {
+	case SWEEP_AND_PRUNE:
+		return std::make_unique<SweepAndPruneBroadphase>();
+	case DYNAMIC_AABB_TREE:
+		return std::make_unique<DynamicAABBTreeBroadphase>();
+	case UNIFORM_GRID:
+	default:
+		return std::make_unique<UniformGridBroadphase>();
+	}
+}
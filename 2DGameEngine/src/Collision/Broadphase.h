@@ -0,0 +1,73 @@
+#pragma once
+#include "CollisionLayers.h"
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Axis aligned bounding box in world space
+/// </summary>
+struct AABB {
+	float minX = 0.0f;
+	float minY = 0.0f;
+	float maxX = 0.0f;
+	float maxY = 0.0f;
+};
+
+/// <summary>
+/// A collider as the broadphase sees it, rebuilt every frame from the
+/// transform and box collider of an entity. The category and mask sit next
+/// to the box so pairs can be filtered without touching any components
+/// </summary>
+struct ColliderProxy {
+	int entityID = -1;
+	AABB box;
+	uint32_t category = CATEGORY_NONE;
+	uint32_t mask = 0;
+
+	// How far a continuous collider moved this frame. Its box then covers the
+	// whole move, from where it started to where it ended up
+	float deltaX = 0.0f;
+	float deltaY = 0.0f;
+};
+
+inline bool canCollide(uint32_t categoryA, uint32_t maskB) {
+	return (categoryA & maskB) != 0;
+}
+
+/// <summary>
+/// Two proxies that may be overlapping. a and b are indices into the proxy
+/// list the broadphase was updated with, and a is always less than b
+/// </summary>
+struct CandidatePair {
+	int a;
+	int b;
+};
+
+enum BroadphaseType {
+	UNIFORM_GRID,
+	SWEEP_AND_PRUNE,
+	DYNAMIC_AABB_TREE
+};
+
+// First item of part when count items are split into partCount nearly equal parts
+inline int partBegin(int count, int part, int partCount) {
+	return static_cast<int>(static_cast<long long>(count) * part / partCount);
+}
+
+/// <summary>
+/// Finds the pairs of colliders that may be overlapping, so the exact
+/// overlap test only runs on those. Backends may keep state between frames,
+/// keyed by entity id
+/// </summary>
+class IBroadphase {
+public:
+	virtual ~IBroadphase() = default;
+	virtual void update(const std::vector<ColliderProxy>& proxies) = 0;
+
+	// Appends the pairs of one part of the search. findPairs only reads the
+	// broadphase, so the parts can run on different threads at the same time,
+	// and together they find every pair exactly once
+	virtual void findPairs(std::vector<CandidatePair>& pairs, int part = 0, int partCount = 1) = 0;
+};
+
+std::unique_ptr<IBroadphase> createBroadphase(BroadphaseType type);
@@ -0,0 +1,83 @@
+#include "ColliderRecording.h"
+#include "../Logger/Logger.h"
+#include <fstream>
+#include <iomanip>
+
+void ColliderRecording::addFrame(const std::vector<ColliderProxy>& proxies) {
+	frames.push_back(proxies);
+}
+
+const std::vector<std::vector<ColliderProxy>>& ColliderRecording::getFrames() const {
+	return frames;
+}
+
+void ColliderRecording::clear() {
+	frames.clear();
+}
+
+bool ColliderRecording::isEmpty() const {
+	return frames.empty();
+}
+
+bool ColliderRecording::save(const std::string& filePath) const {
+
+	std::ofstream file(filePath);
+
+	if (!file) {
+		Logger::LogErr("Failed To Open Collider Recording at " + filePath);
+		return false;
+	}
+
+	file << std::setprecision(9);
+
+	// frame <count>, then one "<entity id> <category> <mask> <minX> <minY> <maxX> <maxY> <deltaX> <deltaY>" line per collider
+	for (const auto& frame : frames) {
+		file << "frame " << frame.size() << "\n";
+
+		for (const auto& proxy : frame) {
+			file << proxy.entityID << " " << proxy.category << " " << proxy.mask << " " << proxy.box.minX << " " << proxy.box.minY << " " << proxy.box.maxX << " " << proxy.box.maxY << " " << proxy.deltaX << " " << proxy.deltaY << "\n";
+		}
+	}
+
+	Logger::Log("Collider Recording saved with " + std::to_string(frames.size()) + " frames to " + filePath);
+
+	return true;
+}
+
+bool ColliderRecording::load(const std::string& filePath) {
+
+	std::ifstream file(filePath);
+
+	if (!file) {
+		Logger::LogErr("Failed To Open Collider Recording at " + filePath);
+		return false;
+	}
+
+	frames.clear();
+
+	std::string tag;
+	size_t count = 0;
+
+	while (file >> tag >> count) {
+
+		if (tag != "frame") {
+			Logger::LogErr("Malformed Collider Recording at " + filePath);
+			return false;
+		}
+
+		std::vector<ColliderProxy> frame(count);
+
+		for (auto& proxy : frame) {
+			file >> proxy.entityID >> proxy.category >> proxy.mask >> proxy.box.minX >> proxy.box.minY >> proxy.box.maxX >> proxy.box.maxY >> proxy.deltaX >> proxy.deltaY;
+		}
+
+		if (!file) {
+			Logger::LogErr("Truncated Collider Recording at " + filePath);
+			return false;
+		}
+
+		frames.push_back(std::move(frame));
+	}
+
+	return true;
+}
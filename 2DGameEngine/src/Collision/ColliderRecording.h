@@ -0,0 +1,28 @@
+#pragma once
+#include "Broadphase.h"
+#include <string>
+#include <vector>
+
+/// <summary>
+/// A sequence of frames of collider proxies, as BoxColliderSystem saw them.
+/// Recordings are saved as plain text so they can be replayed through the
+/// broadphase benchmark
+/// </summary>
+class ColliderRecording {
+
+private:
+
+	std::vector<std::vector<ColliderProxy>> frames;
+
+public:
+
+	ColliderRecording() = default;
+
+	void addFrame(const std::vector<ColliderProxy>& proxies);
+	const std::vector<std::vector<ColliderProxy>>& getFrames() const;
+	void clear();
+	bool isEmpty() const;
+
+	bool save(const std::string& filePath) const;
+	bool load(const std::string& filePath);
+};
@@ -0,0 +1,92 @@
+#include "CollisionDetector.h"
+#include "SweptCollision.h"
+#include <algorithm>
+
+CollisionDetector::CollisionDetector(BroadphaseType type) {
+	setBroadphase(type);
+}
+
+void CollisionDetector::setBroadphase(BroadphaseType type) {
+	broadphaseType = type;
+	broadphase = createBroadphase(type);
+}
+
+BroadphaseType CollisionDetector::getBroadphaseType() const {
+	return broadphaseType;
+}
+
+void CollisionDetector::setParallelThreshold(int proxyCount) {
+	parallelThreshold = proxyCount;
+}
+
+void CollisionDetector::detect(const std::vector<ColliderProxy>& proxies, WorkerPool* workerPool, std::vector<CandidatePair>& contacts) {
+
+	const bool isParallel = workerPool != nullptr && static_cast<int>(proxies.size()) >= parallelThreshold;
+	const int partCount = isParallel ? workerPool->getThreadCount() : 1;
+
+	partPairs.resize(partCount);
+	partContacts.resize(partCount);
+
+	broadphase->update(proxies);
+
+	// Pair search, one list per part
+	auto findPairs = [&](int part) {
+		partPairs[part].clear();
+		broadphase->findPairs(partPairs[part], part, partCount);
+	};
+
+	if (isParallel) {
+		workerPool->run(partCount, findPairs);
+	}
+	else {
+		findPairs(0);
+	}
+
+	candidatePairs.clear();
+
+	for (const auto& pairs : partPairs) {
+		candidatePairs.insert(candidatePairs.end(), pairs.begin(), pairs.end());
+	}
+
+	narrowphase.update(proxies);
+	narrowphase.setCandidates(candidatePairs);
+
+	// Overlap tests, split by first proxy with about the same number of candidates per part
+	auto findHits = [&](int part) {
+		auto& hits = partContacts[part];
+
+		hits.clear();
+		narrowphase.findHits(narrowphase.getPartBegin(part, partCount), narrowphase.getPartBegin(part + 1, partCount), hits);
+
+		// Moving colliders were tested with the box of their whole move, keep
+		// the hits where the two really met at the same moment
+		hits.erase(std::remove_if(hits.begin(), hits.end(), [&](const CandidatePair& hit) {
+			const ColliderProxy& a = proxies[hit.a];
+			const ColliderProxy& b = proxies[hit.b];
+			const bool isSwept = a.deltaX != 0.0f || a.deltaY != 0.0f || b.deltaX != 0.0f || b.deltaY != 0.0f;
+			return isSwept && !sweptOverlap(a, b);
+			}), hits.end());
+	};
+
+	if (isParallel) {
+		workerPool->run(partCount, findHits);
+	}
+	else {
+		findHits(0);
+	}
+
+	contacts.clear();
+
+	for (const auto& partContact : partContacts) {
+		contacts.insert(contacts.end(), partContact.begin(), partContact.end());
+	}
+
+	// The order within a first proxy depends on how the pair search was split
+	std::sort(contacts.begin(), contacts.end(), [](const CandidatePair& lhs, const CandidatePair& rhs) {
+		return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b;
+	});
+}
+
+int CollisionDetector::getCandidateCount() const {
+	return static_cast<int>(candidatePairs.size());
+}
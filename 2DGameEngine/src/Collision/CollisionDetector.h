@@ -0,0 +1,42 @@
+#pragma once
+#include "Broadphase.h"
+#include "Narrowphase.h"
+#include "../Threading/WorkerPool.h"
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Runs the broadphase and the narrowphase over one frame of proxies. Given
+/// a worker pool, both are split into parts that each write into their own
+/// pair and contact lists. The lists are merged and the contacts sorted, so
+/// the result is the same whatever the number of threads
+/// </summary>
+class CollisionDetector {
+
+private:
+
+	BroadphaseType broadphaseType = UNIFORM_GRID;
+	std::unique_ptr<IBroadphase> broadphase;
+	Narrowphase narrowphase;
+
+	std::vector<CandidatePair> candidatePairs;
+	std::vector<std::vector<CandidatePair>> partPairs;
+	std::vector<std::vector<CandidatePair>> partContacts;
+
+	int parallelThreshold = 256;
+
+public:
+
+	CollisionDetector(BroadphaseType type = UNIFORM_GRID);
+
+	void setBroadphase(BroadphaseType type);
+	BroadphaseType getBroadphaseType() const;
+
+	// Below this many proxies a frame is too little work to be worth handing out
+	void setParallelThreshold(int proxyCount);
+
+	// Fills contacts with the overlapping pairs sorted by (a, b). workerPool may be null
+	void detect(const std::vector<ColliderProxy>& proxies, WorkerPool* workerPool, std::vector<CandidatePair>& contacts);
+
+	int getCandidateCount() const;
+};
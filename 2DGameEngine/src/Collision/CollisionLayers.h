@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Collision categories, one bit each. Every box collider belongs to one category
+/// </summary>
+enum CollisionCategory : uint32_t {
+	CATEGORY_NONE = 0,
+	CATEGORY_PLAYER = 1 << 0,
+	CATEGORY_ENEMY = 1 << 1,
+	CATEGORY_PLAYER_PROJECTILE = 1 << 2,
+	CATEGORY_ENEMY_PROJECTILE = 1 << 3
+};
+
+const int MAX_COLLISION_CATEGORIES = 32;
+
+/// <summary>
+/// Which categories collide with which. The matrix is symmetric, so a pair
+/// can be rejected by checking one side: (a.category & b.mask) == 0
+/// </summary>
+class CollisionMatrix {
+
+private:
+
+	// Index = bit of the category, value = the categories it collides with
+	uint32_t masks[MAX_COLLISION_CATEGORIES] = {};
+
+public:
+
+	CollisionMatrix() = default;
+
+	void setInteraction(uint32_t categoryA, uint32_t categoryB, bool collides) {
+		for (int bit = 0; bit < MAX_COLLISION_CATEGORIES; bit++) {
+			if (categoryA & (1u << bit)) {
+				masks[bit] = collides ? masks[bit] | categoryB : masks[bit] & ~categoryB;
+			}
+			if (categoryB & (1u << bit)) {
+				masks[bit] = collides ? masks[bit] | categoryA : masks[bit] & ~categoryA;
+			}
+		}
+	}
+
+	uint32_t getMask(uint32_t category) const {
+		uint32_t mask = 0;
+		for (int bit = 0; bit < MAX_COLLISION_CATEGORIES; bit++) {
+			if (category & (1u << bit)) {
+				mask |= masks[bit];
+			}
+		}
+		return mask;
+	}
+
+	// The pairs the game responds to, everything else is never tested
+	static CollisionMatrix createDefault() {
+		CollisionMatrix matrix;
+		matrix.setInteraction(CATEGORY_PLAYER, CATEGORY_ENEMY, true);
+		matrix.setInteraction(CATEGORY_PLAYER, CATEGORY_ENEMY_PROJECTILE, true);
+		matrix.setInteraction(CATEGORY_ENEMY, CATEGORY_PLAYER_PROJECTILE, true);
+		return matrix;
+	}
+};
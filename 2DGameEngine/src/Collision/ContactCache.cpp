@@ -0,0 +1,80 @@
+#include "ContactCache.h"
+#include <algorithm>
+
+uint64_t ContactCache::pairKey(int entityA, int entityB) {
+
+	const uint32_t low = static_cast<uint32_t>(std::min(entityA, entityB));
+	const uint32_t high = static_cast<uint32_t>(std::max(entityA, entityB));
+
+	return (static_cast<uint64_t>(low) << 32) | high;
+}
+
+void ContactCache::setTrackingStay(bool isTrackingStay) {
+	this->isTrackingStay = isTrackingStay;
+}
+
+void ContactCache::update(const std::vector<CandidatePair>& contacts, const std::vector<ColliderProxy>& proxies) {
+
+	std::swap(this->contacts, previousContacts);
+	this->contacts.clear();
+
+	for (const auto& contact : contacts) {
+		this->contacts.push_back({ pairKey(proxies[contact.a].entityID, proxies[contact.b].entityID), contact });
+	}
+
+	std::sort(this->contacts.begin(), this->contacts.end(), [](const CachedContact& lhs, const CachedContact& rhs) {
+		return lhs.key < rhs.key;
+	});
+
+	began.clear();
+	stayed.clear();
+	ended.clear();
+
+	// Both lists are sorted by key, so one merge finds every transition
+	size_t current = 0;
+	size_t previous = 0;
+
+	while (current < this->contacts.size() || previous < previousContacts.size()) {
+
+		if (previous == previousContacts.size() || (current < this->contacts.size() && this->contacts[current].key < previousContacts[previous].key)) {
+			began.push_back(this->contacts[current].proxies);
+			current++;
+		}
+		else if (current == this->contacts.size() || previousContacts[previous].key < this->contacts[current].key) {
+			const uint64_t key = previousContacts[previous].key;
+			ended.push_back({ static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFFu) });
+			previous++;
+		}
+		else {
+			if (isTrackingStay) {
+				stayed.push_back(this->contacts[current].proxies);
+			}
+			current++;
+			previous++;
+		}
+	}
+}
+
+const std::vector<CandidatePair>& ContactCache::getBegan() const {
+	return began;
+}
+
+const std::vector<CandidatePair>& ContactCache::getStayed() const {
+	return stayed;
+}
+
+const std::vector<EntityPair>& ContactCache::getEnded() const {
+	return ended;
+}
+
+int ContactCache::getContactCount() const {
+	return static_cast<int>(contacts.size());
+}
+
+void ContactCache::clear() {
+	contacts.clear();
+	previousContacts.clear();
+	began.clear();
+	stayed.clear();
+	ended.clear();
+}
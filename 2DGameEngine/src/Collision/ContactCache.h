@@ -0,0 +1,59 @@
+#pragma once
+#include "Broadphase.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Two entities whose colliders stopped overlapping. Either of them may have
+/// been killed since, so only the ids are kept
+/// </summary>
+struct EntityPair {
+	int entityA;
+	int entityB;
+};
+
+/// <summary>
+/// The overlapping collider pairs carried from frame to frame, keyed by the
+/// ids of the two entities. Each update compares the new contacts with the
+/// previous ones and reports which pairs began and which ended, so responses
+/// run once per contact rather than once per frame of overlap
+/// </summary>
+class ContactCache {
+
+private:
+
+	struct CachedContact {
+		uint64_t key;
+		CandidatePair proxies;
+	};
+
+	// Sorted by key
+	std::vector<CachedContact> contacts;
+	std::vector<CachedContact> previousContacts;
+
+	std::vector<CandidatePair> began;
+	std::vector<CandidatePair> stayed;
+	std::vector<EntityPair> ended;
+
+	bool isTrackingStay = false;
+
+	static uint64_t pairKey(int entityA, int entityB);
+
+public:
+
+	ContactCache() = default;
+
+	// Stayed contacts are only collected when something listens for them
+	void setTrackingStay(bool isTrackingStay);
+
+	// contacts are proxy pairs into proxies, as the narrowphase reports them
+	void update(const std::vector<CandidatePair>& contacts, const std::vector<ColliderProxy>& proxies);
+
+	// Proxy pairs of the last update, ordered by entity pair
+	const std::vector<CandidatePair>& getBegan() const;
+	const std::vector<CandidatePair>& getStayed() const;
+	const std::vector<EntityPair>& getEnded() const;
+
+	int getContactCount() const;
+	void clear();
+};
@@ -0,0 +1,392 @@
+#include "DynamicAABBTreeBroadphase.h"
+#include <algorithm>
+
+namespace {
+
+	AABB combine(const AABB& a, const AABB& b) {
+		return AABB{
+			std::min(a.minX, b.minX),
+			std::min(a.minY, b.minY),
+			std::max(a.maxX, b.maxX),
+			std::max(a.maxY, b.maxY)
+		};
+	}
+
+	// In 2D the perimeter plays the part the surface area plays in 3D trees
+	float perimeter(const AABB& box) {
+		return 2.0f * ((box.maxX - box.minX) + (box.maxY - box.minY));
+	}
+
+	bool contains(const AABB& outer, const AABB& inner) {
+		return outer.minX <= inner.minX && outer.minY <= inner.minY && outer.maxX >= inner.maxX && outer.maxY >= inner.maxY;
+	}
+
+	bool overlaps(const AABB& a, const AABB& b) {
+		return a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY;
+	}
+}
+
+DynamicAABBTreeBroadphase::DynamicAABBTreeBroadphase(float margin) : margin(margin) {};
+
+int DynamicAABBTreeBroadphase::allocateNode() {
+
+	if (freeList == NULL_NODE) {
+		nodes.emplace_back();
+		return static_cast<int>(nodes.size()) - 1;
+	}
+
+	// Free nodes are chained through their parent index
+	int node = freeList;
+	freeList = nodes[node].parent;
+	nodes[node] = Node();
+
+	return node;
+}
+
+void DynamicAABBTreeBroadphase::freeNode(int node) {
+	nodes[node].parent = freeList;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+void DynamicAABBTreeBroadphase::insertLeaf(int leaf) {
+
+	if (root == NULL_NODE) {
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Walk down to the sibling that grows the total perimeter the least
+	const AABB leafBox = nodes[leaf].box;
+	int index = root;
+
+	while (!nodes[index].isLeaf()) {
+
+		const Node& node = nodes[index];
+
+		const float area = perimeter(node.box);
+		const float combinedArea = perimeter(combine(node.box, leafBox));
+
+		// Cost of making a new parent for this node and the leaf
+		const float cost = 2.0f * combinedArea;
+
+		// Cost that every node below this one pays for growing it
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		const int children[2] = { node.left, node.right };
+
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[children[i]];
+			const float childArea = perimeter(combine(leafBox, child.box));
+			childCosts[i] = (child.isLeaf() ? childArea : childArea - perimeter(child.box)) + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) {
+			break;
+		}
+
+		index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+	}
+
+	const int sibling = index;
+	const int oldParent = nodes[sibling].parent;
+	const int newParent = allocateNode();
+
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].box = combine(leafBox, nodes[sibling].box);
+	nodes[newParent].category = nodes[leaf].category | nodes[sibling].category;
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].left = sibling;
+	nodes[newParent].right = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE) {
+		root = newParent;
+	}
+	else if (nodes[oldParent].left == sibling) {
+		nodes[oldParent].left = newParent;
+	}
+	else {
+		nodes[oldParent].right = newParent;
+	}
+
+	refit(nodes[leaf].parent);
+}
+
+void DynamicAABBTreeBroadphase::removeLeaf(int leaf) {
+
+	if (leaf == root) {
+		root = NULL_NODE;
+		return;
+	}
+
+	const int parent = nodes[leaf].parent;
+	const int grandParent = nodes[parent].parent;
+	const int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+	freeNode(parent);
+
+	if (grandParent == NULL_NODE) {
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		return;
+	}
+
+	if (nodes[grandParent].left == parent) {
+		nodes[grandParent].left = sibling;
+	}
+	else {
+		nodes[grandParent].right = sibling;
+	}
+
+	nodes[sibling].parent = grandParent;
+
+	refit(grandParent);
+}
+
+void DynamicAABBTreeBroadphase::refit(int node) {
+
+	while (node != NULL_NODE) {
+
+		node = balance(node);
+
+		const int left = nodes[node].left;
+		const int right = nodes[node].right;
+
+		nodes[node].height = 1 + std::max(nodes[left].height, nodes[right].height);
+		nodes[node].box = combine(nodes[left].box, nodes[right].box);
+		nodes[node].category = nodes[left].category | nodes[right].category;
+
+		node = nodes[node].parent;
+	}
+}
+
+int DynamicAABBTreeBroadphase::balance(int iA) {
+
+	// Rotates the taller child of A up when the children differ in height by more than one.
+	// Returns the node that now sits where A was
+	Node* A = &nodes[iA];
+
+	if (A->isLeaf() || A->height < 2) {
+		return iA;
+	}
+
+	const int iB = A->left;
+	const int iC = A->right;
+	Node* B = &nodes[iB];
+	Node* C = &nodes[iC];
+
+	const int difference = C->height - B->height;
+
+	if (difference > 1) {
+
+		const int iF = C->left;
+		const int iG = C->right;
+		Node* F = &nodes[iF];
+		Node* G = &nodes[iG];
+
+		C->left = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if (C->parent == NULL_NODE) {
+			root = iC;
+		}
+		else if (nodes[C->parent].left == iA) {
+			nodes[C->parent].left = iC;
+		}
+		else {
+			nodes[C->parent].right = iC;
+		}
+
+		// Keep the taller of F and G under C
+		if (F->height > G->height) {
+			C->right = iF;
+			A->right = iG;
+			G->parent = iA;
+			A->box = combine(B->box, G->box);
+			C->box = combine(A->box, F->box);
+			A->category = B->category | G->category;
+			C->category = A->category | F->category;
+			A->height = 1 + std::max(B->height, G->height);
+			C->height = 1 + std::max(A->height, F->height);
+		}
+		else {
+			C->right = iG;
+			A->right = iF;
+			F->parent = iA;
+			A->box = combine(B->box, F->box);
+			C->box = combine(A->box, G->box);
+			A->category = B->category | F->category;
+			C->category = A->category | G->category;
+			A->height = 1 + std::max(B->height, F->height);
+			C->height = 1 + std::max(A->height, G->height);
+		}
+
+		return iC;
+	}
+
+	if (difference < -1) {
+
+		const int iD = B->left;
+		const int iE = B->right;
+		Node* D = &nodes[iD];
+		Node* E = &nodes[iE];
+
+		B->left = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if (B->parent == NULL_NODE) {
+			root = iB;
+		}
+		else if (nodes[B->parent].left == iA) {
+			nodes[B->parent].left = iB;
+		}
+		else {
+			nodes[B->parent].right = iB;
+		}
+
+		// Keep the taller of D and E under B
+		if (D->height > E->height) {
+			B->right = iD;
+			A->left = iE;
+			E->parent = iA;
+			A->box = combine(C->box, E->box);
+			B->box = combine(A->box, D->box);
+			A->category = C->category | E->category;
+			B->category = A->category | D->category;
+			A->height = 1 + std::max(C->height, E->height);
+			B->height = 1 + std::max(A->height, D->height);
+		}
+		else {
+			B->right = iE;
+			A->left = iD;
+			D->parent = iA;
+			A->box = combine(C->box, D->box);
+			B->box = combine(A->box, E->box);
+			A->category = C->category | D->category;
+			B->category = A->category | E->category;
+			A->height = 1 + std::max(C->height, D->height);
+			B->height = 1 + std::max(A->height, E->height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void DynamicAABBTreeBroadphase::update(const std::vector<ColliderProxy>& proxies) {
+
+	frame++;
+
+	std::fill(proxyOfEntity.begin(), proxyOfEntity.end(), -1);
+	leaves.clear();
+
+	for (int i = 0; i < static_cast<int>(proxies.size()); i++) {
+
+		const int entityID = proxies[i].entityID;
+		const AABB& box = proxies[i].box;
+
+		if (entityID >= static_cast<int>(leafOfEntity.size())) {
+			leafOfEntity.resize(entityID + 1, NULL_NODE);
+			lastSeenFrame.resize(entityID + 1, 0);
+			proxyOfEntity.resize(entityID + 1, -1);
+		}
+
+		proxyOfEntity[entityID] = i;
+		lastSeenFrame[entityID] = frame;
+
+		int leaf = leafOfEntity[entityID];
+
+		// A leaf only has to move when it leaves its fat box, or when its category
+		// changes, since the categories are also summed up in its ancestors
+		if (leaf != NULL_NODE && contains(nodes[leaf].box, box) && nodes[leaf].category == proxies[i].category) {
+			nodes[leaf].mask = proxies[i].mask;
+			leaves.push_back(leaf);
+			continue;
+		}
+
+		if (leaf == NULL_NODE) {
+			leaf = allocateNode();
+			nodes[leaf].entityID = entityID;
+			nodes[leaf].height = 0;
+			leafOfEntity[entityID] = leaf;
+		}
+		else {
+			removeLeaf(leaf);
+		}
+
+		nodes[leaf].box = AABB{ box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin };
+		nodes[leaf].category = proxies[i].category;
+		nodes[leaf].mask = proxies[i].mask;
+		insertLeaf(leaf);
+		leaves.push_back(leaf);
+	}
+
+	// Entities that were not in this frame's list have been removed from the system
+	for (int entityID = 0; entityID < static_cast<int>(leafOfEntity.size()); entityID++) {
+
+		const int leaf = leafOfEntity[entityID];
+
+		if (leaf != NULL_NODE && lastSeenFrame[entityID] != frame) {
+			removeLeaf(leaf);
+			freeNode(leaf);
+			leafOfEntity[entityID] = NULL_NODE;
+		}
+	}
+}
+
+void DynamicAABBTreeBroadphase::findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) {
+
+	const int count = static_cast<int>(leaves.size());
+	const int last = partBegin(count, part + 1, partCount);
+
+	// Every part walks the tree with its own stack
+	std::vector<int> stack;
+
+	// Fat boxes are tested against fat boxes, so every pair is found from both of its
+	// leaves and only reported from the one with the lower proxy index
+	for (int i = partBegin(count, part, partCount); i < last; i++) {
+
+		const int leaf = leaves[i];
+		const AABB& box = nodes[leaf].box;
+		const uint32_t mask = nodes[leaf].mask;
+
+		if (mask == 0) {
+			continue;
+		}
+
+		stack.clear();
+		stack.push_back(root);
+
+		while (!stack.empty()) {
+
+			const int index = stack.back();
+			stack.pop_back();
+
+			const Node& node = nodes[index];
+
+			// Skips whole subtrees that hold nothing this leaf collides with
+			if (!canCollide(node.category, mask) || !overlaps(node.box, box)) {
+				continue;
+			}
+
+			if (!node.isLeaf()) {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+				continue;
+			}
+
+			const int other = proxyOfEntity[node.entityID];
+
+			if (other > i) {
+				pairs.push_back({ i, other });
+			}
+		}
+	}
+}
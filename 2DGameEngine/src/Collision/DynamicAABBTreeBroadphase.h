@@ -0,0 +1,62 @@
+#pragma once
+#include "Broadphase.h"
+#include <vector>
+
+/// <summary>
+/// Bounding volume hierarchy that is updated in place. Every leaf stores a
+/// fat box, a little larger than the collider, so a collider only has to be
+/// re-inserted once it leaves its fat box. Suited to sparse worlds where the
+/// colliders are spread far apart and a grid would be mostly empty cells
+/// </summary>
+class DynamicAABBTreeBroadphase : public IBroadphase {
+
+private:
+
+	static constexpr int NULL_NODE = -1;
+
+	struct Node {
+		AABB box;
+		int parent = NULL_NODE;
+		int left = NULL_NODE;
+		int right = NULL_NODE;
+		// Leaves have height 0, free nodes -1
+		int height = -1;
+		int entityID = -1;
+		// For internal nodes, every category found below the node
+		uint32_t category = CATEGORY_NONE;
+		uint32_t mask = 0;
+
+		bool isLeaf() const {
+			return left == NULL_NODE;
+		}
+	};
+
+	float margin;
+
+	std::vector<Node> nodes;
+	int root = NULL_NODE;
+	int freeList = NULL_NODE;
+
+	// Entity id -> leaf node, and the frame the entity was last seen in
+	std::vector<int> leafOfEntity;
+	std::vector<int> lastSeenFrame;
+	int frame = 0;
+
+	// Entity id -> index into the proxy list of the current frame
+	std::vector<int> proxyOfEntity;
+	std::vector<int> leaves;
+
+	int allocateNode();
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int balance(int node);
+	void refit(int node);
+
+public:
+
+	DynamicAABBTreeBroadphase(float margin = 8.0f);
+
+	void update(const std::vector<ColliderProxy>& proxies) override;
+	void findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) override;
+};
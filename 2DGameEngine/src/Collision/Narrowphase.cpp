@@ -0,0 +1,184 @@
+#include "Narrowphase.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NARROWPHASE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define NARROWPHASE_NEON
+#include <arm_neon.h>
+#endif
+
+void ColliderBoxes::assign(const std::vector<ColliderProxy>& proxies) {
+
+	const size_t count = proxies.size();
+
+	minX.resize(count);
+	minY.resize(count);
+	maxX.resize(count);
+	maxY.resize(count);
+
+	for (size_t i = 0; i < count; i++) {
+		minX[i] = proxies[i].box.minX;
+		minY[i] = proxies[i].box.minY;
+		maxX[i] = proxies[i].box.maxX;
+		maxY[i] = proxies[i].box.maxY;
+	}
+}
+
+int ColliderBoxes::size() const {
+	return static_cast<int>(minX.size());
+}
+
+#if defined(NARROWPHASE_SSE2) || defined(NARROWPHASE_NEON)
+
+// Overlap bits of one box against the four candidates starting at first. Lanes past
+// the last candidate repeat it and are masked off by the caller
+static inline int overlapBlock(const ColliderBoxes& boxes, int index, const int* candidates, int first, int last) {
+
+	const float* minX = boxes.minX.data();
+	const float* minY = boxes.minY.data();
+	const float* maxX = boxes.maxX.data();
+	const float* maxY = boxes.maxY.data();
+
+	const int c0 = candidates[first <= last ? first : last];
+	const int c1 = candidates[first + 1 <= last ? first + 1 : last];
+	const int c2 = candidates[first + 2 <= last ? first + 2 : last];
+	const int c3 = candidates[first + 3 <= last ? first + 3 : last];
+
+#if defined(NARROWPHASE_SSE2)
+	const __m128 bMinX = _mm_setr_ps(minX[c0], minX[c1], minX[c2], minX[c3]);
+	const __m128 bMinY = _mm_setr_ps(minY[c0], minY[c1], minY[c2], minY[c3]);
+	const __m128 bMaxX = _mm_setr_ps(maxX[c0], maxX[c1], maxX[c2], maxX[c3]);
+	const __m128 bMaxY = _mm_setr_ps(maxY[c0], maxY[c1], maxY[c2], maxY[c3]);
+
+	const __m128 overlap = _mm_and_ps(
+		_mm_and_ps(_mm_cmplt_ps(_mm_set1_ps(minX[index]), bMaxX), _mm_cmpgt_ps(_mm_set1_ps(maxX[index]), bMinX)),
+		_mm_and_ps(_mm_cmplt_ps(_mm_set1_ps(minY[index]), bMaxY), _mm_cmpgt_ps(_mm_set1_ps(maxY[index]), bMinY)));
+
+	return _mm_movemask_ps(overlap);
+#else
+	const float bMinX[4] = { minX[c0], minX[c1], minX[c2], minX[c3] };
+	const float bMinY[4] = { minY[c0], minY[c1], minY[c2], minY[c3] };
+	const float bMaxX[4] = { maxX[c0], maxX[c1], maxX[c2], maxX[c3] };
+	const float bMaxY[4] = { maxY[c0], maxY[c1], maxY[c2], maxY[c3] };
+	const uint32x4_t laneBits = { 1, 2, 4, 8 };
+
+	const uint32x4_t overlap = vandq_u32(
+		vandq_u32(vcltq_f32(vdupq_n_f32(minX[index]), vld1q_f32(bMaxX)), vcgtq_f32(vdupq_n_f32(maxX[index]), vld1q_f32(bMinX))),
+		vandq_u32(vcltq_f32(vdupq_n_f32(minY[index]), vld1q_f32(bMaxY)), vcgtq_f32(vdupq_n_f32(maxY[index]), vld1q_f32(bMinY))));
+
+	return static_cast<int>(vaddvq_u32(vandq_u32(overlap, laneBits)));
+#endif
+}
+
+#endif
+
+int overlapBatch(const ColliderBoxes& boxes, int index, const int* candidates, int count, int* hits) {
+
+	int hitCount = 0;
+
+#if defined(NARROWPHASE_SSE2) || defined(NARROWPHASE_NEON)
+
+	const int last = count - 1;
+
+	// Eight candidates per iteration, as two blocks of four lanes
+	for (int i = 0; i < count; i += 8) {
+
+		int bits = overlapBlock(boxes, index, candidates, i, last) | (overlapBlock(boxes, index, candidates, i + 4, last) << 4);
+
+		const int remaining = count - i;
+		if (remaining < 8) {
+			bits &= (1 << remaining) - 1;
+		}
+
+		// Branchless compaction, every lane is written and only the hits advance
+		for (int lane = 0; lane < 8; lane++) {
+			hits[hitCount] = candidates[i + lane <= last ? i + lane : last];
+			hitCount += (bits >> lane) & 1;
+		}
+	}
+
+#else
+
+	const float* minX = boxes.minX.data();
+	const float* minY = boxes.minY.data();
+	const float* maxX = boxes.maxX.data();
+	const float* maxY = boxes.maxY.data();
+
+	for (int i = 0; i < count; i++) {
+		const int c = candidates[i];
+		hits[hitCount] = c;
+		hitCount += (minX[index] < maxX[c] && maxX[index] > minX[c] && minY[index] < maxY[c] && maxY[index] > minY[c]) ? 1 : 0;
+	}
+
+#endif
+
+	return hitCount;
+}
+
+void Narrowphase::update(const std::vector<ColliderProxy>& proxies) {
+	boxes.assign(proxies);
+}
+
+void Narrowphase::setCandidates(const std::vector<CandidatePair>& pairs) {
+
+	// Counting sort on the first proxy, which keeps the broadphase order within a group
+	const int proxyCount = boxes.size();
+
+	candidateStarts.assign(proxyCount + 1, 0);
+
+	for (const auto& pair : pairs) {
+		candidateStarts[pair.a + 1]++;
+	}
+
+	for (int i = 0; i < proxyCount; i++) {
+		candidateStarts[i + 1] += candidateStarts[i];
+	}
+
+	candidates.resize(pairs.size());
+
+	std::vector<int> next(candidateStarts.begin(), candidateStarts.end() - 1);
+
+	for (const auto& pair : pairs) {
+		candidates[next[pair.a]++] = pair.b;
+	}
+}
+
+void Narrowphase::findHits(int firstProxy, int lastProxy, std::vector<CandidatePair>& contacts) const {
+
+	const int batchSize = 64;
+	int batchHits[batchSize];
+
+	for (int proxy = firstProxy; proxy < lastProxy; proxy++) {
+
+		const int end = candidateStarts[proxy + 1];
+
+		for (int start = candidateStarts[proxy]; start < end; start += batchSize) {
+
+			const int count = end - start < batchSize ? end - start : batchSize;
+			const int hitCount = overlapBatch(boxes, proxy, &candidates[start], count, batchHits);
+
+			for (int i = 0; i < hitCount; i++) {
+				contacts.push_back({ proxy, batchHits[i] });
+			}
+		}
+	}
+}
+
+int Narrowphase::getPartBegin(int part, int partCount) const {
+
+	const int proxyCount = boxes.size();
+
+	if (part >= partCount) {
+		return proxyCount;
+	}
+
+	const int target = partBegin(static_cast<int>(candidates.size()), part, partCount);
+
+	return static_cast<int>(std::lower_bound(candidateStarts.begin(), candidateStarts.begin() + proxyCount, target) - candidateStarts.begin());
+}
+
+int Narrowphase::getProxyCount() const {
+	return boxes.size();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Broadphase.h"
+#include <vector>
+
+/// <summary>
+/// Collider boxes packed as structure of arrays, so four or eight boxes can
+/// be loaded into one SIMD register per edge
+/// </summary>
+struct ColliderBoxes {
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+
+	void assign(const std::vector<ColliderProxy>& proxies);
+	int size() const;
+};
+
+/// <summary>
+/// Exact overlap test for the candidate pairs of the broadphase. Candidates
+/// are grouped by their first proxy, and each proxy is then tested against
+/// its candidates eight at a time
+/// </summary>
+class Narrowphase {
+
+private:
+
+	ColliderBoxes boxes;
+
+	// Candidates grouped by first proxy: the second proxies of proxy i are
+	// candidates[candidateStarts[i]] up to candidates[candidateStarts[i + 1]]
+	std::vector<int> candidateStarts;
+	std::vector<int> candidates;
+
+public:
+
+	Narrowphase() = default;
+
+	void update(const std::vector<ColliderProxy>& proxies);
+	void setCandidates(const std::vector<CandidatePair>& pairs);
+
+	// Appends the overlapping pairs whose first proxy is in [firstProxy, lastProxy),
+	// ordered by first proxy
+	void findHits(int firstProxy, int lastProxy, std::vector<CandidatePair>& contacts) const;
+
+	// First proxy of part when the proxies are split into partCount parts
+	// with about the same number of candidates each
+	int getPartBegin(int part, int partCount) const;
+
+	int getProxyCount() const;
+};
+
+// Tests one box against count candidate boxes and writes the indices of the
+// overlapping ones to hits. Returns the number of hits. hits needs room for
+// count rounded up to a multiple of 8
+int overlapBatch(const ColliderBoxes& boxes, int index, const int* candidates, int count, int* hits);
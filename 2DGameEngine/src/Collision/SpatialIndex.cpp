@@ -0,0 +1,328 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+	float distanceToBox(float x, float y, const AABB& box) {
+		const float dx = std::max({ box.minX - x, 0.0f, x - box.maxX });
+		const float dy = std::max({ box.minY - y, 0.0f, y - box.maxY });
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	// Distance along the ray to where it enters the box, false if it misses it within maxDistance
+	bool rayToBox(float x, float y, float directionX, float directionY, float maxDistance, const AABB& box, float& distance) {
+
+		float enter = 0.0f;
+		float exit = maxDistance;
+
+		const float origin[2] = { x, y };
+		const float direction[2] = { directionX, directionY };
+		const float minimum[2] = { box.minX, box.minY };
+		const float maximum[2] = { box.maxX, box.maxY };
+
+		for (int axis = 0; axis < 2; axis++) {
+
+			if (direction[axis] == 0.0f) {
+				if (origin[axis] < minimum[axis] || origin[axis] > maximum[axis]) {
+					return false;
+				}
+				continue;
+			}
+
+			float axisEnter = (minimum[axis] - origin[axis]) / direction[axis];
+			float axisExit = (maximum[axis] - origin[axis]) / direction[axis];
+
+			if (axisEnter > axisExit) {
+				std::swap(axisEnter, axisExit);
+			}
+
+			enter = std::max(enter, axisEnter);
+			exit = std::min(exit, axisExit);
+
+			if (enter > exit) {
+				return false;
+			}
+		}
+
+		distance = enter;
+		return true;
+	}
+}
+
+SpatialIndex::SpatialIndex(float cellSize) : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {};
+
+int SpatialIndex::toCell(float value) const {
+	return static_cast<int>(std::floor(value * inverseCellSize));
+}
+
+uint64_t SpatialIndex::cellKey(int cellX, int cellY) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+int SpatialIndex::bucketOf(uint64_t cell) const {
+	return bucketBits == 0 ? 0 : static_cast<int>((cell * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits));
+}
+
+void SpatialIndex::build(const std::vector<SpatialItem>& items) {
+
+	this->items = items;
+
+	std::vector<CellEntry> unsorted;
+
+	minCellX = minCellY = 0;
+	maxCellX = maxCellY = -1;
+
+	for (int i = 0; i < static_cast<int>(items.size()); i++) {
+
+		const AABB& box = items[i].box;
+
+		const int firstX = toCell(box.minX);
+		const int firstY = toCell(box.minY);
+		const int lastX = toCell(box.maxX);
+		const int lastY = toCell(box.maxY);
+
+		if (i == 0) {
+			minCellX = firstX;
+			minCellY = firstY;
+			maxCellX = lastX;
+			maxCellY = lastY;
+		}
+
+		minCellX = std::min(minCellX, firstX);
+		minCellY = std::min(minCellY, firstY);
+		maxCellX = std::max(maxCellX, lastX);
+		maxCellY = std::max(maxCellY, lastY);
+
+		for (int cellY = firstY; cellY <= lastY; cellY++) {
+			for (int cellX = firstX; cellX <= lastX; cellX++) {
+				unsorted.push_back({ cellKey(cellX, cellY), i });
+			}
+		}
+	}
+
+	bucketBits = 0;
+	while ((static_cast<size_t>(1) << bucketBits) < unsorted.size()) {
+		bucketBits++;
+	}
+
+	const int bucketCount = 1 << bucketBits;
+
+	bucketStarts.assign(bucketCount + 1, 0);
+
+	for (const auto& entry : unsorted) {
+		bucketStarts[bucketOf(entry.cell) + 1]++;
+	}
+
+	for (int i = 0; i < bucketCount; i++) {
+		bucketStarts[i + 1] += bucketStarts[i];
+	}
+
+	entries.resize(unsorted.size());
+
+	std::vector<int> next(bucketStarts.begin(), bucketStarts.end() - 1);
+
+	for (const auto& entry : unsorted) {
+		entries[next[bucketOf(entry.cell)]++] = entry;
+	}
+}
+
+template <typename TVisit>
+void SpatialIndex::forEachInCell(int cellX, int cellY, uint32_t layerMask, TVisit visit) const {
+
+	if (entries.empty()) {
+		return;
+	}
+
+	const uint64_t cell = cellKey(cellX, cellY);
+	const int bucket = bucketOf(cell);
+
+	for (int i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; i++) {
+		if (entries[i].cell == cell && (items[entries[i].item].layers & layerMask)) {
+			visit(entries[i].item);
+		}
+	}
+}
+
+void SpatialIndex::queryRect(const AABB& rect, uint32_t layerMask, std::vector<int>& results) const {
+
+	const int firstX = std::max(toCell(rect.minX), minCellX);
+	const int firstY = std::max(toCell(rect.minY), minCellY);
+	const int lastX = std::min(toCell(rect.maxX), maxCellX);
+	const int lastY = std::min(toCell(rect.maxY), maxCellY);
+
+	for (int cellY = firstY; cellY <= lastY; cellY++) {
+		for (int cellX = firstX; cellX <= lastX; cellX++) {
+			forEachInCell(cellX, cellY, layerMask, [&](int item) {
+
+				const AABB& box = items[item].box;
+
+				if (box.minX > rect.maxX || box.maxX < rect.minX || box.minY > rect.maxY || box.maxY < rect.minY) {
+					return;
+				}
+
+				// An item can cover several of the cells, only the one holding the top left
+				// corner of the overlap reports it
+				if (toCell(std::max(box.minX, rect.minX)) == cellX && toCell(std::max(box.minY, rect.minY)) == cellY) {
+					results.push_back(item);
+				}
+			});
+		}
+	}
+}
+
+void SpatialIndex::queryRadius(float x, float y, float radius, uint32_t layerMask, std::vector<int>& results) const {
+
+	const size_t first = results.size();
+
+	queryRect(AABB{ x - radius, y - radius, x + radius, y + radius }, layerMask, results);
+
+	results.erase(std::remove_if(results.begin() + first, results.end(), [&](int item) {
+		return distanceToBox(x, y, items[item].box) > radius;
+		}), results.end());
+}
+
+void SpatialIndex::nearestK(float x, float y, int k, uint32_t layerMask, std::vector<int>& results, float maxDistance) const {
+
+	if (k <= 0 || items.empty()) {
+		return;
+	}
+
+	std::vector<std::pair<float, int>> found;
+
+	const int centreX = toCell(x);
+	const int centreY = toCell(y);
+
+	// Rings of cells around the point. Before ring r is searched, everything not yet
+	// found is at least r - 1 cells away, so the search stops once k items are closer than that
+	const int lastRing = std::max({ centreX - minCellX, maxCellX - centreX, centreY - minCellY, maxCellY - centreY });
+
+	for (int ring = 0; ring <= lastRing; ring++) {
+
+		const float ringDistance = (ring - 1) * cellSize;
+
+		if (ringDistance > maxDistance) {
+			break;
+		}
+
+		// Items covering several cells are found more than once
+		std::sort(found.begin(), found.end());
+		found.erase(std::unique(found.begin(), found.end()), found.end());
+
+		if (static_cast<int>(found.size()) >= k && found[k - 1].first <= ringDistance) {
+			break;
+		}
+
+		// Only the cells of the ring that lie inside the area holding items
+		const int top = centreY - ring;
+		const int bottom = centreY + ring;
+		const int left = centreX - ring;
+		const int right = centreX + ring;
+
+		auto visitCell = [&](int cellX, int cellY) {
+			forEachInCell(cellX, cellY, layerMask, [&](int item) {
+				const float distance = distanceToBox(x, y, items[item].box);
+				if (distance <= maxDistance) {
+					found.push_back({ distance, item });
+				}
+			});
+		};
+
+		for (int cellY = std::max(top, minCellY); cellY <= std::min(bottom, maxCellY); cellY++) {
+
+			if (cellY == top || cellY == bottom) {
+				for (int cellX = std::max(left, minCellX); cellX <= std::min(right, maxCellX); cellX++) {
+					visitCell(cellX, cellY);
+				}
+				continue;
+			}
+
+			// Inner rows only have the two cells on the sides of the ring
+			if (left >= minCellX) {
+				visitCell(left, cellY);
+			}
+			if (right <= maxCellX) {
+				visitCell(right, cellY);
+			}
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+
+	for (int i = 0; i < static_cast<int>(found.size()) && i < k; i++) {
+		results.push_back(found[i].second);
+	}
+}
+
+bool SpatialIndex::raycast(float x, float y, float directionX, float directionY, float maxDistance, uint32_t layerMask, SpatialRayHit& hit) const {
+
+	const float length = std::sqrt(directionX * directionX + directionY * directionY);
+
+	if (length == 0.0f || items.empty()) {
+		return false;
+	}
+
+	directionX /= length;
+	directionY /= length;
+
+	// Walk the cells along the ray, nearest first
+	int cellX = toCell(x);
+	int cellY = toCell(y);
+
+	const int stepX = directionX > 0.0f ? 1 : -1;
+	const int stepY = directionY > 0.0f ? 1 : -1;
+
+	const float deltaX = directionX != 0.0f ? std::abs(cellSize / directionX) : 1e30f;
+	const float deltaY = directionY != 0.0f ? std::abs(cellSize / directionY) : 1e30f;
+
+	float nextX = directionX != 0.0f ? ((cellX + (stepX > 0 ? 1 : 0)) * cellSize - x) / directionX : 1e30f;
+	float nextY = directionY != 0.0f ? ((cellY + (stepY > 0 ? 1 : 0)) * cellSize - y) / directionY : 1e30f;
+
+	hit.item = -1;
+	hit.distance = maxDistance;
+
+	float cellEnter = 0.0f;
+
+	while (cellEnter <= hit.distance) {
+
+		forEachInCell(cellX, cellY, layerMask, [&](int item) {
+			float distance;
+			if (rayToBox(x, y, directionX, directionY, hit.distance, items[item].box, distance) && (hit.item == -1 || distance < hit.distance)) {
+				hit.item = item;
+				hit.distance = distance;
+			}
+		});
+
+		// A box found in this cell may only be hit further along the ray, and a box
+		// in the next cell can be hit before that, so walk on until the cells start past the hit
+		if (nextX < nextY) {
+			cellEnter = nextX;
+			nextX += deltaX;
+			cellX += stepX;
+		}
+		else {
+			cellEnter = nextY;
+			nextY += deltaY;
+			cellY += stepY;
+		}
+
+		// Left the area that holds items and is heading away from it
+		if ((stepX > 0 ? cellX > maxCellX : cellX < minCellX) && directionX != 0.0f) {
+			break;
+		}
+		if ((stepY > 0 ? cellY > maxCellY : cellY < minCellY) && directionY != 0.0f) {
+			break;
+		}
+		if ((directionX == 0.0f && (cellX < minCellX || cellX > maxCellX)) || (directionY == 0.0f && (cellY < minCellY || cellY > maxCellY))) {
+			break;
+		}
+	}
+
+	return hit.item != -1;
+}
+
+int SpatialIndex::getItemCount() const {
+	return static_cast<int>(items.size());
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Broadphase.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Something the spatial index holds. layers is a bit set the queries filter on
+/// </summary>
+struct SpatialItem {
+	AABB box;
+	uint32_t layers = 0;
+};
+
+struct SpatialRayHit {
+	int item = -1;
+	float distance = 0.0f;
+};
+
+/// <summary>
+/// Hashed grid over a frame's worth of items, for gameplay queries. Results
+/// are indices into the item list it was built from. Queries only read the
+/// index, so any number of them can run at the same time
+/// </summary>
+class SpatialIndex {
+
+private:
+
+	struct CellEntry {
+		uint64_t cell;
+		int item;
+	};
+
+	float cellSize;
+	float inverseCellSize;
+
+	std::vector<SpatialItem> items;
+
+	// One entry per (cell, item), grouped by hash bucket with a counting sort
+	std::vector<CellEntry> entries;
+	std::vector<int> bucketStarts;
+	int bucketBits = 0;
+
+	// Cells covered by any item, the searches that grow outwards stop there
+	int minCellX = 0;
+	int minCellY = 0;
+	int maxCellX = -1;
+	int maxCellY = -1;
+
+	int toCell(float value) const;
+	static uint64_t cellKey(int cellX, int cellY);
+	int bucketOf(uint64_t cell) const;
+
+	// Calls visit(item) for every entry of a cell
+	template <typename TVisit>
+	void forEachInCell(int cellX, int cellY, uint32_t layerMask, TVisit visit) const;
+
+public:
+
+	SpatialIndex(float cellSize = 64.0f);
+
+	void build(const std::vector<SpatialItem>& items);
+
+	// Items whose box overlaps the rectangle
+	void queryRect(const AABB& rect, uint32_t layerMask, std::vector<int>& results) const;
+
+	// Items whose box is within radius of the point
+	void queryRadius(float x, float y, float radius, uint32_t layerMask, std::vector<int>& results) const;
+
+	// Up to k items closest to the point, nearest first, measured to the edge of their box
+	void nearestK(float x, float y, int k, uint32_t layerMask, std::vector<int>& results, float maxDistance = 1e30f) const;
+
+	// First item hit by a ray from (x, y) along the direction, which need not be normalised
+	bool raycast(float x, float y, float directionX, float directionY, float maxDistance, uint32_t layerMask, SpatialRayHit& hit) const;
+
+	int getItemCount() const;
+};
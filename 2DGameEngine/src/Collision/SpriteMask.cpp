@@ -0,0 +1,217 @@
+#include "SpriteMask.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+SpriteMask::SpriteMask(int width, int height) :
+	width(width),
+	height(height),
+	wordsPerRow((width + 63) / 64),
+	bits(static_cast<size_t>((width + 63) / 64) * height, 0) {};
+
+SpriteMask SpriteMask::fromRGBA(const uint8_t* pixels, int width, int height, int pitch, uint8_t alphaThreshold) {
+
+	SpriteMask mask(width, height);
+
+	for (int y = 0; y < height; y++) {
+
+		const uint8_t* row = pixels + static_cast<size_t>(y) * pitch;
+
+		for (int x = 0; x < width; x++) {
+			if (row[x * 4 + 3] > alphaThreshold) {
+				mask.set(x, y);
+			}
+		}
+	}
+
+	return mask;
+}
+
+uint64_t SpriteMask::getWord(int row, int word) const {
+
+	if (word < 0 || word >= wordsPerRow) {
+		return 0;
+	}
+
+	return bits[static_cast<size_t>(row) * wordsPerRow + word];
+}
+
+uint64_t SpriteMask::getBits(int row, int firstBit) const {
+
+	if (firstBit <= -64) {
+		return 0;
+	}
+
+	if (firstBit < 0) {
+		return getWord(row, 0) << -firstBit;
+	}
+
+	const int word = firstBit >> 6;
+	const int shift = firstBit & 63;
+
+	if (shift == 0) {
+		return getWord(row, word);
+	}
+
+	return (getWord(row, word) >> shift) | (getWord(row, word + 1) << (64 - shift));
+}
+
+bool SpriteMask::get(int x, int y) const {
+
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+
+	return (bits[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+void SpriteMask::set(int x, int y) {
+	bits[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] |= static_cast<uint64_t>(1) << (x & 63);
+}
+
+SpriteMask SpriteMask::transformed(int srcX, int srcY, int srcWidth, int srcHeight, int width, int height, double degrees) const {
+
+	const double radians = degrees * 3.14159265358979323846 / 180.0;
+	const double cosine = std::cos(radians);
+	const double sine = std::sin(radians);
+
+	// Size of the rotated rectangle
+	const int rotatedWidth = static_cast<int>(std::ceil(std::abs(width * cosine) + std::abs(height * sine) - 1e-6));
+	const int rotatedHeight = static_cast<int>(std::ceil(std::abs(width * sine) + std::abs(height * cosine) - 1e-6));
+
+	SpriteMask mask(rotatedWidth, rotatedHeight);
+	mask.offsetX = (width - rotatedWidth) / 2;
+	mask.offsetY = (height - rotatedHeight) / 2;
+
+	const double centreX = width * 0.5;
+	const double centreY = height * 0.5;
+	const double scaleX = static_cast<double>(srcWidth) / width;
+	const double scaleY = static_cast<double>(srcHeight) / height;
+
+	// Rotate the centre of every pixel of the mask back onto the sprite and sample the source there
+	for (int y = 0; y < rotatedHeight; y++) {
+		for (int x = 0; x < rotatedWidth; x++) {
+
+			const double dx = mask.offsetX + x + 0.5 - centreX;
+			const double dy = mask.offsetY + y + 0.5 - centreY;
+
+			const double spriteX = centreX + dx * cosine + dy * sine;
+			const double spriteY = centreY - dx * sine + dy * cosine;
+
+			if (spriteX < 0.0 || spriteY < 0.0 || spriteX >= width || spriteY >= height) {
+				continue;
+			}
+
+			const int sourceX = srcX + static_cast<int>(spriteX * scaleX);
+			const int sourceY = srcY + static_cast<int>(spriteY * scaleY);
+
+			if (get(sourceX, sourceY)) {
+				mask.set(x, y);
+			}
+		}
+	}
+
+	return mask;
+}
+
+int SpriteMask::getWidth() const {
+	return width;
+}
+
+int SpriteMask::getHeight() const {
+	return height;
+}
+
+int SpriteMask::getOffsetX() const {
+	return offsetX;
+}
+
+int SpriteMask::getOffsetY() const {
+	return offsetY;
+}
+
+bool SpriteMask::overlap(const SpriteMask& a, int ax, int ay, const SpriteMask& b, int bx, int by) {
+
+	ax += a.offsetX;
+	ay += a.offsetY;
+	bx += b.offsetX;
+	by += b.offsetY;
+
+	const int minX = std::max(ax, bx);
+	const int minY = std::max(ay, by);
+	const int maxX = std::min(ax + a.width, bx + b.width);
+	const int maxY = std::min(ay + a.height, by + b.height);
+
+	if (minX >= maxX || minY >= maxY) {
+		return false;
+	}
+
+	const int firstWord = (minX - ax) >> 6;
+	const int lastWord = (maxX - 1 - ax) >> 6;
+
+	for (int y = minY; y < maxY; y++) {
+
+		const int rowA = y - ay;
+		const int rowB = y - by;
+
+		// Line the pixels of b up with each word of a. Bits outside either mask are
+		// clear, so the words need no clipping to the overlap
+		for (int word = firstWord; word <= lastWord; word++) {
+			if (a.getWord(rowA, word) & b.getBits(rowB, ax + word * 64 - bx)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool SpriteMaskCache::SpriteKey::operator <(const SpriteKey& other) const {
+	return std::tie(srcX, srcY, srcWidth, srcHeight, width, height, angleStep) <
+		std::tie(other.srcX, other.srcY, other.srcWidth, other.srcHeight, other.width, other.height, other.angleStep);
+}
+
+void SpriteMaskCache::addTexture(const std::string& assetid, SpriteMask mask) {
+	textures[assetid] = TextureMasks{ std::move(mask), {} };
+}
+
+void SpriteMaskCache::clear() {
+	textures.clear();
+}
+
+const SpriteMask* SpriteMaskCache::getMask(const std::string& assetid, int srcX, int srcY, int srcWidth, int srcHeight, int width, int height, double degrees) {
+
+	auto texture = textures.find(assetid);
+
+	if (texture == textures.end()) {
+		return nullptr;
+	}
+
+	TextureMasks& masks = texture->second;
+
+	if (srcWidth == 0 && srcHeight == 0) {
+		srcWidth = masks.texture.getWidth();
+		srcHeight = masks.texture.getHeight();
+	}
+
+	if (width <= 0 || height <= 0) {
+		return nullptr;
+	}
+
+	// Round the rotation to the nearest step
+	int angleStep = static_cast<int>(std::lround(degrees * ANGLE_STEPS / 360.0)) % ANGLE_STEPS;
+	if (angleStep < 0) {
+		angleStep += ANGLE_STEPS;
+	}
+
+	const SpriteKey key{ srcX, srcY, srcWidth, srcHeight, width, height, angleStep };
+
+	auto sprite = masks.sprites.find(key);
+
+	if (sprite == masks.sprites.end()) {
+		SpriteMask mask = masks.texture.transformed(srcX, srcY, srcWidth, srcHeight, width, height, angleStep * 360.0 / ANGLE_STEPS);
+		sprite = masks.sprites.emplace(key, std::move(mask)).first;
+	}
+
+	return &sprite->second;
+}
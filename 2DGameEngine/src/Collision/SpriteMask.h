@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// One bit per pixel of a sprite, set where the sprite is solid. Every row
+/// is packed into 64 bit words, so two masks are compared 64 pixels at a time
+/// </summary>
+class SpriteMask {
+
+private:
+
+	int width = 0;
+	int height = 0;
+	int wordsPerRow = 0;
+
+	// Where the top left of the mask sits relative to the top left of the sprite.
+	// A rotated sprite covers more than its rectangle, so its mask starts further out
+	int offsetX = 0;
+	int offsetY = 0;
+
+	// Bit x % 64 of word x / 64 is pixel x, bits past the width are always clear
+	std::vector<uint64_t> bits;
+
+	uint64_t getWord(int row, int word) const;
+	// The 64 pixels of a row starting at firstBit, clear where they fall outside the mask
+	uint64_t getBits(int row, int firstBit) const;
+
+public:
+
+	SpriteMask() = default;
+	SpriteMask(int width, int height);
+
+	// pixels are 32 bit RGBA, a pixel is solid when its alpha is above alphaThreshold
+	static SpriteMask fromRGBA(const uint8_t* pixels, int width, int height, int pitch, uint8_t alphaThreshold = 127);
+
+	bool get(int x, int y) const;
+	void set(int x, int y);
+
+	// The part of this mask inside the source rectangle, scaled to width by height and
+	// rotated clockwise about its centre, the way SDL_RenderCopyEx draws it
+	SpriteMask transformed(int srcX, int srcY, int srcWidth, int srcHeight, int width, int height, double degrees) const;
+
+	int getWidth() const;
+	int getHeight() const;
+	int getOffsetX() const;
+	int getOffsetY() const;
+
+	// Whether two masks share a solid pixel, given the top left corners of their sprites
+	static bool overlap(const SpriteMask& a, int ax, int ay, const SpriteMask& b, int bx, int by);
+};
+
+/// <summary>
+/// The mask of every texture, and the masks of the sprites drawn from them.
+/// Sprite masks are made on first use and kept, with rotations rounded to
+/// one of ANGLE_STEPS angles so only a few versions of each sprite exist
+/// </summary>
+class SpriteMaskCache {
+
+private:
+
+	struct SpriteKey {
+		int srcX, srcY, srcWidth, srcHeight;
+		int width, height;
+		int angleStep;
+
+		bool operator <(const SpriteKey& other) const;
+	};
+
+	struct TextureMasks {
+		SpriteMask texture;
+		std::map<SpriteKey, SpriteMask> sprites;
+	};
+
+	std::unordered_map<std::string, TextureMasks> textures;
+
+public:
+
+	static const int ANGLE_STEPS = 64;
+
+	SpriteMaskCache() = default;
+
+	void addTexture(const std::string& assetid, SpriteMask mask);
+	void clear();
+
+	// Null when the texture has no mask. A source rectangle of 0 by 0 is the whole texture
+	const SpriteMask* getMask(const std::string& assetid, int srcX, int srcY, int srcWidth, int srcHeight, int width, int height, double degrees);
+};
@@ -0,0 +1,90 @@
+#include "SweepAndPruneBroadphase.h"
+#include <algorithm>
+
+void SweepAndPruneBroadphase::update(const std::vector<ColliderProxy>& proxies) {
+
+	std::fill(proxyOfEntity.begin(), proxyOfEntity.end(), -1);
+
+	for (int i = 0; i < static_cast<int>(proxies.size()); i++) {
+
+		const int entityID = proxies[i].entityID;
+
+		if (entityID >= static_cast<int>(proxyOfEntity.size())) {
+			proxyOfEntity.resize(entityID + 1, -1);
+		}
+
+		proxyOfEntity[entityID] = i;
+	}
+
+	isSorted.assign(proxies.size(), false);
+
+	// Refresh the boxes of the proxies we already know about, dropping the ones that are gone
+	sortedProxies.erase(std::remove_if(sortedProxies.begin(), sortedProxies.end(), [&](SortedProxy& sortedProxy) {
+
+		const int proxy = proxyOfEntity[sortedProxy.entityID];
+
+		// Removed this frame, or an id that was handed out twice
+		if (proxy == -1 || isSorted[proxy]) {
+			return true;
+		}
+
+		sortedProxy.box = proxies[proxy].box;
+		sortedProxy.category = proxies[proxy].category;
+		sortedProxy.mask = proxies[proxy].mask;
+		sortedProxy.proxy = proxy;
+		isSorted[proxy] = true;
+
+		return false;
+		}), sortedProxies.end());
+
+	// New proxies go on the end and are moved into place by the sort below
+	for (int i = 0; i < static_cast<int>(proxies.size()); i++) {
+		if (!isSorted[i]) {
+			sortedProxies.push_back({ proxies[i].box, proxies[i].category, proxies[i].mask, proxies[i].entityID, i });
+		}
+	}
+
+	for (int i = 1; i < static_cast<int>(sortedProxies.size()); i++) {
+
+		SortedProxy current = sortedProxies[i];
+		int j = i - 1;
+
+		while (j >= 0 && sortedProxies[j].box.minX > current.box.minX) {
+			sortedProxies[j + 1] = sortedProxies[j];
+			j--;
+		}
+
+		sortedProxies[j + 1] = current;
+	}
+}
+
+void SweepAndPruneBroadphase::findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) {
+
+	const int count = static_cast<int>(sortedProxies.size());
+	const int last = partBegin(count, part + 1, partCount);
+
+	// Each part sweeps from its own slice of the sorted list, the inner loop may run past it
+	for (int i = partBegin(count, part, partCount); i < last; i++) {
+
+		const SortedProxy& first = sortedProxies[i];
+
+		// Everything after i starts further right, so stop at the first one that starts past our right edge
+		for (int j = i + 1; j < count && sortedProxies[j].box.minX <= first.box.maxX; j++) {
+
+			const SortedProxy& second = sortedProxies[j];
+
+			if (!canCollide(first.category, second.mask)) {
+				continue;
+			}
+
+			if (first.box.minY > second.box.maxY || second.box.minY > first.box.maxY) {
+				continue;
+			}
+
+			pairs.push_back({
+				std::min(first.proxy, second.proxy),
+				std::max(first.proxy, second.proxy)
+			});
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Broadphase.h"
+#include <vector>
+
+/// <summary>
+/// Incremental sweep and prune along the x axis. The proxies are kept sorted
+/// by their left edge between frames, and since everything in a side scroller
+/// moves a little each frame the list is nearly sorted and an insertion sort
+/// restores it in close to linear time
+/// </summary>
+class SweepAndPruneBroadphase : public IBroadphase {
+
+private:
+
+	struct SortedProxy {
+		AABB box;
+		uint32_t category;
+		uint32_t mask;
+		int entityID;
+		int proxy;
+	};
+
+	std::vector<SortedProxy> sortedProxies;
+
+	// Entity id -> index into the proxy list of the current frame, -1 if absent
+	std::vector<int> proxyOfEntity;
+	std::vector<bool> isSorted;
+
+public:
+
+	SweepAndPruneBroadphase() = default;
+
+	void update(const std::vector<ColliderProxy>& proxies) override;
+	void findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) override;
+};
@@ -0,0 +1,81 @@
+#include "SweptCollision.h"
+#include <algorithm>
+
+namespace {
+
+	// Narrows [enter, exit] to the part of the frame in which a's slab overlaps b's
+	// on one axis, a moving by delta relative to b. False if they never overlap
+	bool clipAxis(float aMin, float aMax, float bMin, float bMax, float delta, float& enter, float& exit) {
+
+		if (delta == 0.0f) {
+			return aMin <= bMax && aMax >= bMin;
+		}
+
+		float axisEnter = (bMin - aMax) / delta;
+		float axisExit = (bMax - aMin) / delta;
+
+		if (axisEnter > axisExit) {
+			std::swap(axisEnter, axisExit);
+		}
+
+		enter = std::max(enter, axisEnter);
+		exit = std::min(exit, axisExit);
+
+		return enter <= exit;
+	}
+}
+
+AABB sweepBox(const AABB& end, float deltaX, float deltaY) {
+	return AABB{
+		end.minX - std::max(deltaX, 0.0f),
+		end.minY - std::max(deltaY, 0.0f),
+		end.maxX - std::min(deltaX, 0.0f),
+		end.maxY - std::min(deltaY, 0.0f)
+	};
+}
+
+AABB sweepStart(const AABB& swept, float deltaX, float deltaY) {
+	return AABB{
+		swept.minX - std::min(deltaX, 0.0f),
+		swept.minY - std::min(deltaY, 0.0f),
+		swept.maxX - std::max(deltaX, 0.0f),
+		swept.maxY - std::max(deltaY, 0.0f)
+	};
+}
+
+AABB sweepEnd(const AABB& swept, float deltaX, float deltaY) {
+	return AABB{
+		swept.minX + std::max(deltaX, 0.0f),
+		swept.minY + std::max(deltaY, 0.0f),
+		swept.maxX + std::min(deltaX, 0.0f),
+		swept.maxY + std::min(deltaY, 0.0f)
+	};
+}
+
+bool sweptOverlap(const ColliderProxy& a, const ColliderProxy& b, float* enterTime, float* exitTime) {
+
+	const AABB startA = sweepStart(a.box, a.deltaX, a.deltaY);
+	const AABB startB = sweepStart(b.box, b.deltaX, b.deltaY);
+
+	// Hold b still and move a by the difference
+	const float deltaX = a.deltaX - b.deltaX;
+	const float deltaY = a.deltaY - b.deltaY;
+
+	float enter = 0.0f;
+	float exit = 1.0f;
+
+	if (!clipAxis(startA.minX, startA.maxX, startB.minX, startB.maxX, deltaX, enter, exit) ||
+		!clipAxis(startA.minY, startA.maxY, startB.minY, startB.maxY, deltaY, enter, exit)) {
+		return false;
+	}
+
+	if (enterTime) {
+		*enterTime = enter;
+	}
+
+	if (exitTime) {
+		*exitTime = exit;
+	}
+
+	return true;
+}
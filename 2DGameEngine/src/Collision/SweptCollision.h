@@ -0,0 +1,14 @@
+#pragma once
+#include "Broadphase.h"
+
+// Box covering a collider that ended the frame at end after moving by (deltaX, deltaY)
+AABB sweepBox(const AABB& end, float deltaX, float deltaY);
+
+// The boxes a swept box started and ended the frame at
+AABB sweepStart(const AABB& swept, float deltaX, float deltaY);
+AABB sweepEnd(const AABB& swept, float deltaX, float deltaY);
+
+// Whether two swept proxies touched at any point of the frame. Both move at a
+// steady speed, so this is a slab test of their relative motion. enterTime and
+// exitTime are set to the fractions of the frame at which their boxes met and parted
+bool sweptOverlap(const ColliderProxy& a, const ColliderProxy& b, float* enterTime = nullptr, float* exitTime = nullptr);
@@ -0,0 +1,130 @@
+#include "UniformGridBroadphase.h"
+#include <algorithm>
+#include <cmath>
+
+UniformGridBroadphase::UniformGridBroadphase(float cellSize) {
+	setCellSize(cellSize);
+}
+
+void UniformGridBroadphase::setCellSize(float cellSize) {
+	this->cellSize = cellSize;
+	this->inverseCellSize = 1.0f / cellSize;
+}
+
+float UniformGridBroadphase::getCellSize() const {
+	return cellSize;
+}
+
+int UniformGridBroadphase::toCell(float value) const {
+	return static_cast<int>(std::floor(value * inverseCellSize));
+}
+
+uint64_t UniformGridBroadphase::cellKey(int cellX, int cellY) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+int UniformGridBroadphase::bucketOf(uint64_t cell) const {
+	// Fibonacci hashing, the top bits of the product are the best mixed
+	return bucketBits == 0 ? 0 : static_cast<int>((cell * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits));
+}
+
+void UniformGridBroadphase::update(const std::vector<ColliderProxy>& proxies) {
+
+	this->proxies = proxies;
+	entries.clear();
+
+	for (int i = 0; i < static_cast<int>(proxies.size()); i++) {
+
+		const AABB& box = proxies[i].box;
+
+		const int minCellX = toCell(box.minX);
+		const int minCellY = toCell(box.minY);
+		const int maxCellX = toCell(box.maxX);
+		const int maxCellY = toCell(box.maxY);
+
+		for (int cellY = minCellY; cellY <= maxCellY; cellY++) {
+			for (int cellX = minCellX; cellX <= maxCellX; cellX++) {
+				entries.push_back({ cellKey(cellX, cellY), i });
+			}
+		}
+	}
+
+	// Roughly one bucket per entry keeps the buckets short
+	bucketBits = 0;
+	while ((static_cast<size_t>(1) << bucketBits) < entries.size()) {
+		bucketBits++;
+	}
+
+	const int bucketCount = 1 << bucketBits;
+
+	bucketStarts.assign(bucketCount + 1, 0);
+
+	for (const auto& entry : entries) {
+		bucketStarts[bucketOf(entry.cell) + 1]++;
+	}
+
+	for (int i = 0; i < bucketCount; i++) {
+		bucketStarts[i + 1] += bucketStarts[i];
+	}
+
+	sortedEntries.resize(entries.size());
+
+	std::vector<int> next(bucketStarts.begin(), bucketStarts.end() - 1);
+
+	for (const auto& entry : entries) {
+		sortedEntries[next[bucketOf(entry.cell)]++] = entry;
+	}
+}
+
+void UniformGridBroadphase::findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) {
+
+	// A cell lives in one bucket, so splitting by bucket never splits a cell.
+	// There is about one bucket per entry, which keeps the parts even
+	const int bucketCount = static_cast<int>(bucketStarts.size()) - 1;
+	const int lastBucket = partBegin(bucketCount, part + 1, partCount);
+
+	for (int bucket = partBegin(bucketCount, part, partCount); bucket < lastBucket; bucket++) {
+
+		const int end = bucketStarts[bucket + 1];
+
+		for (int i = bucketStarts[bucket]; i < end; i++) {
+
+			const CellEntry& first = sortedEntries[i];
+
+			for (int j = i + 1; j < end; j++) {
+
+				const CellEntry& second = sortedEntries[j];
+
+				// Different cells that happen to hash to the same bucket
+				if (first.cell != second.cell) {
+					continue;
+				}
+
+				const ColliderProxy& proxyA = proxies[first.proxy];
+				const ColliderProxy& proxyB = proxies[second.proxy];
+
+				if (!canCollide(proxyA.category, proxyB.mask)) {
+					continue;
+				}
+
+				const AABB& a = proxyA.box;
+				const AABB& b = proxyB.box;
+
+				// Two proxies can share several cells. Only the cell holding the top left
+				// corner of their overlap reports the pair, so it is reported once
+				const uint64_t ownerCell = cellKey(
+					toCell(std::max(a.minX, b.minX)),
+					toCell(std::max(a.minY, b.minY)));
+
+				if (ownerCell != first.cell) {
+					continue;
+				}
+
+				pairs.push_back({
+					std::min(first.proxy, second.proxy),
+					std::max(first.proxy, second.proxy)
+				});
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Broadphase.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Spatial hash broadphase. Every proxy is inserted into each grid cell its
+/// AABB touches, and only proxies sharing a cell become candidate pairs.
+/// The grid is rebuilt from scratch every frame, so the cost grows with the
+/// number of colliders rather than the number of collider pairs.
+/// </summary>
+class UniformGridBroadphase : public IBroadphase {
+
+private:
+
+	struct CellEntry {
+		uint64_t cell;
+		int proxy;
+	};
+
+	float cellSize;
+	float inverseCellSize;
+
+	std::vector<ColliderProxy> proxies;
+
+	// One entry per (cell, proxy), grouped by hash bucket with a counting sort
+	std::vector<CellEntry> entries;
+	std::vector<CellEntry> sortedEntries;
+	std::vector<int> bucketStarts;
+	int bucketBits = 0;
+
+	int toCell(float value) const;
+	static uint64_t cellKey(int cellX, int cellY);
+	int bucketOf(uint64_t cell) const;
+
+public:
+
+	// Ships and enemies are 24-36px, so a 64px cell keeps most colliders within 1-4 cells
+	UniformGridBroadphase(float cellSize = 64.0f);
+
+	void setCellSize(float cellSize);
+	float getCellSize() const;
+
+	void update(const std::vector<ColliderProxy>& proxies) override;
+	void findPairs(std::vector<CandidatePair>& pairs, int part, int partCount) override;
+};
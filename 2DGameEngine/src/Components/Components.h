@@ -2,6 +2,11 @@
 
 #include <glm/glm.hpp>
 #include "../ECS/ESC.h"
+#include "../Collision/CollisionLayers.h"
+#include "../Time/SimulationClock.h"
+#include "../Particles/ParticlePool.h"
+#include "../TileMap/TileMap.h"
+#include "../Text/TextLayout.h"
 #include <SDL.h>
 #include <memory>
 
@@ -22,12 +27,18 @@ struct TransformComponent {
 	glm::vec2 scale;
 	double rotation;
 
+	// Where the entity was at the start of the current tick, drawing blends from there
+	glm::vec2 previousPosition;
+	double previousRotation;
+
 	TransformComponent() = default;
 
 	TransformComponent(glm::vec2 position, glm::vec2 scale, double rotation) {
 		this->position = position;
 		this->scale = scale;
 		this->rotation = rotation;
+		this->previousPosition = position;
+		this->previousRotation = rotation;
 	}
 };
 
@@ -37,6 +48,8 @@ struct SpriteComponent {
 	glm::vec2 size;
 	SDL_Rect srcRect;
 	bool isFixed;
+	// Resolved from the asset id the first time the sprite is drawn
+	int textureID = -1;
 	
 	SpriteComponent(
 		std::string assetid = "",
@@ -51,32 +64,24 @@ struct SpriteComponent {
 	}
 };
 
+// Added through AnimationSystem::play, which schedules the frame changes
 struct AnimationComponent {
 
-	// Number of frames in the sequence
-	int numFrames;
-	// Which frame of the sequence are we at
+	// Index of the clip in the animation system
+	int clipID;
+	// Which frame of the clip is showing
 	int currentFrame;
-	// How fast should the animation "move"/change frame
-	int frameSpeedRate;
-
-	bool isLoop;
-	int loopCount;
 	int startTime;
-
-	int loopsCompleted = 0;
-
-	AnimationComponent(
-		int numFrames = 0,
-		int frameSpeedRate = 0,
-		bool isLoop = false,
-		int loopCount = 0) {
-		this->numFrames = numFrames;
-		this->currentFrame = 1;
-		this->frameSpeedRate = frameSpeedRate;
-		this->isLoop = isLoop;
-		this->loopCount = loopCount;
-		this->startTime = SDL_GetTicks();
+	int loopsCompleted;
+	// Tells this playback apart from an earlier one on the same entity id
+	int playID;
+
+	AnimationComponent(int clipID = -1, int playID = 0) {
+		this->clipID = clipID;
+		this->currentFrame = 0;
+		this->startTime = SimulationClock::getTicks();
+		this->loopsCompleted = 0;
+		this->playID = playID;
 	}
 };
 
@@ -84,15 +89,22 @@ struct BoxColliderComponent {
 	int width;
 	int height;
 	glm::vec2 offset;
+	uint32_t category;
+	// Fast colliders are tested along their whole move each frame, so they cannot pass through thin ones
+	bool isContinuous;
 
 	BoxColliderComponent(
 		int width = 0,
 		int height = 0,
-		glm::vec2 offset = glm::vec2(0, 0)) {
+		glm::vec2 offset = glm::vec2(0, 0),
+		uint32_t category = CATEGORY_NONE,
+		bool isContinuous = false) {
 
 		this->width = width;
 		this->height = height;
 		this->offset = offset;
+		this->category = category;
+		this->isContinuous = isContinuous;
 	}
 };
 
@@ -173,7 +185,7 @@ struct ProjectileEmitterComponent {
 		this->projectileDuration = projecttileDuration;
 		this->hitPercentDamage = hitPercentDamage;
 		this->isFriendly = isFriendly;
-		this->lastEmissionTime = SDL_GetTicks();
+		this->lastEmissionTime = SimulationClock::getTicks();
 		this->direction = direction;
 	}
 
@@ -194,7 +206,7 @@ struct ProjectileComponent {
 		this->projectileDuration = projecttileDuration;
 		this->hitPercentDamage = hitPercentDamage;
 		this->isFriendly = isFriendly;
-		this->startTime = SDL_GetTicks();
+		this->startTime = SimulationClock::getTicks();
 	}
 };
 
@@ -207,16 +219,26 @@ struct HealthComponent {
 	}
 };
 
-struct BackgroundComponent {
-	
-	std::string assetID;
-	SDL_FRect background;
-
-	BackgroundComponent(std::string assetID = "", 
-		glm::vec2 position = glm::vec2(0, 0), 
-		glm::vec2 size = glm::vec2(0, 0)) :
-		assetID(assetID),
-		background(SDL_FRect{ position.x, position.y, size.x, size.y }) {
+struct TileMapComponent {
+
+	std::shared_ptr<const TileMap> tileMap;
+	// How far the layer scrolls for every pixel the level does, far layers are below 1
+	float parallax;
+	// Repeats left and right instead of ending
+	bool isRepeating;
+	glm::vec2 scroll;
+	// Scroll at the start of the current tick
+	glm::vec2 previousScroll;
+
+	TileMapComponent(
+		std::shared_ptr<const TileMap> tileMap = nullptr,
+		float parallax = 1.0f,
+		bool isRepeating = true) :
+		tileMap(tileMap),
+		parallax(parallax),
+		isRepeating(isRepeating),
+		scroll(0, 0),
+		previousScroll(0, 0) {
 	};
 };
 
@@ -233,19 +255,27 @@ struct ExplosionComponent {
 struct TextLabelComponent {
 
 	std::string assetid;
+	// The anchor the text is aligned to, laid out again whenever it is drawn
 	glm::vec2 position;
 	std::string text;
 	SDL_Color textColor;
+	TextAlign align;
+	// Lines wrap at spaces past this many pixels, 0 keeps them whole
+	int wrapWidth;
 
 	TextLabelComponent(
 		std::string assetid = "",
 		glm::vec2 position = glm::vec2(0, 0),
 		std::string text = "",
-		SDL_Color textColor = { 255, 255, 255 }) {
+		SDL_Color textColor = { 255, 255, 255, 255 },
+		TextAlign align = TextAlign::left,
+		int wrapWidth = 0) {
 		this->assetid = assetid;
 		this->position = position;
 		this->text = text;
 		this->textColor = textColor;
+		this->align = align;
+		this->wrapWidth = wrapWidth;
 	}
 };
 
@@ -298,3 +328,27 @@ struct LifeComponent {
 
 	LifeComponent(int lives = 3) : lives(lives) {};
 };
+
+struct ParticleEmitterComponent {
+
+	// Name of a style added to the particle system
+	std::string style;
+	int styleID = -1;
+	// Particles per second
+	float rate;
+	// Where particles start relative to the centre of the sprite, turned with the entity.
+	// The emission direction is relative to the entity's rotation too
+	glm::vec2 offset;
+	ParticleEmission emission;
+	float accumulator = 0.0f;
+
+	ParticleEmitterComponent(
+		std::string style = "",
+		float rate = 0.0f,
+		glm::vec2 offset = glm::vec2(0, 0),
+		ParticleEmission emission = ParticleEmission()) :
+		style(style),
+		rate(rate),
+		offset(offset),
+		emission(emission) {};
+};
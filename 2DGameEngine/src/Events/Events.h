@@ -16,6 +16,29 @@ public:
 	CollisionEvent(Entity& a, Entity& b) : a(a), b(b) {};
 };
 
+class ImpactEvent : public Event {
+
+public:
+
+	const Entity& projectile;
+
+	ImpactEvent(const Entity& projectile) : projectile(projectile) {};
+};
+
+class AnimationCompleteEvent : public Event {
+
+public:
+
+	Entity entity;
+	std::unique_ptr<EventBus>& eventBus;
+	std::unique_ptr<Registry>& registry;
+
+	AnimationCompleteEvent(Entity entity, std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry) :
+		entity(entity),
+		eventBus(eventBus),
+		registry(registry) {};
+};
+
 class KeyboardEvent : public Event {
 
 public:
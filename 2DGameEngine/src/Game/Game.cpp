@@ -5,13 +5,21 @@
 #include "../System/RenderSystems.h"
 #include "../System/EnemySpawnSystem.h"
 #include "../System/AISystem.h"
+#include "../System/SpatialIndexSystem.h"
+#include "../System/ViewportCullingSystem.h"
 #include "../System/BackgroundMusicSystem.h"
 #include "../System/SoundEffectSystem.h"
 #include "../System/EngineSoundSystem.h"
+#include "../System/ParticleSystem.h"
+#include "../System/TileMapSystem.h"
 #include <glm/glm.hpp>
 #include "../Helpers/Colours.h"
 #include "../Helpers/Helpers.h"
 #include "../Helpers/Styling.h"
+#include "../Time/SimulationClock.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
 
 int Game::windowHeight = 720;
 int Game::windowWidth = 1024;
@@ -19,10 +27,10 @@ int Game::mapHeight = 688;
 int Game::mapWidth = 1024;
 int Game::mapOffset = Game::windowHeight - Game::mapHeight;
 
-Game::Game()
+Game::Game(bool isSoftwareRendering)
 	: isRunning(false),
-	msPreviousFrame(0),
-	deltaTime(0),
+	tickRate(TICK_RATE),
+	isSoftwareRendering(isSoftwareRendering),
 	displayMode(SDL_DisplayMode()),
 	window(SDL_CreateWindow(
 		NULL,
@@ -34,10 +42,11 @@ Game::Game()
 	renderer(SDL_CreateRenderer(
 		window,
 		-1,
-		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)),
+		(isSoftwareRendering ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED) | SDL_RENDERER_PRESENTVSYNC)),
 	registry(std::make_unique<Registry>()),
 	assetStore(std::make_unique<AssetStore>()),
 	eventBus(std::make_unique<EventBus>()),
+	workerPool(std::make_unique<WorkerPool>()),
 	isDebug(false)
 {
 	Logger::Log("Game Object Created");
@@ -74,6 +83,10 @@ Game::Game()
 		Logger::LogErr("Error creating SDL Renderer");
 	};
 
+	if (isSoftwareRendering) {
+		createSoftwareRasterizer();
+	}
+
 	setCenterValues();
 	setup();
 
@@ -85,6 +98,30 @@ Game::~Game()
 	Logger::Log("Game Object Deconstructed");
 };
 
+void Game::createSoftwareRasterizer() {
+
+	// Textures can not be read back, so the store keeps a copy of everything it loads
+	assetStore->keepImages(true);
+
+	framebuffer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, Game::windowWidth, Game::windowHeight);
+
+	if (framebuffer == nullptr) {
+		Logger::LogErr(SDL_GetError());
+		return;
+	}
+
+	rasterizerPool = std::make_unique<WorkerPool>();
+	rasterizer = std::make_unique<SoftwareRasterizer>(rasterizerPool.get());
+	rasterizer->resize(Game::windowWidth, Game::windowHeight);
+
+	AssetStore* store = assetStore.get();
+	rasterizer->setImageLookup([store](SDL_Texture* texture) {
+		return store->getImage(texture);
+	});
+
+	Logger::Log("Rendering in software");
+}
+
 void Game::setCenterValues() {
 	centerX = static_cast<float>(Game::mapWidth) * 0.5f;
 	centerY = static_cast<float>(Game::mapHeight) * 0.5f;
@@ -95,6 +132,8 @@ void Game::loadLevel(int level) {
 	addSystems();
 	setupEventSubscriptions();
 	addTextures();
+	addParticleStyles();
+	addAnimationClips();
 	addFonts();
 	addSounds();
 	createBackground();
@@ -105,8 +144,25 @@ void Game::loadLevel(int level) {
 }
 
 void Game::createBackground() {
+	const TextureInfo* tileset = assetStore->getTextureInfo("space");
+
+	if (tileset == nullptr) {
+		return;
+	}
+
+	// The space image is cut into tiles and laid over the map, chunks of 8 by 8 tiles are cached
+	const int tileSize = 64;
+
+	auto stars = std::make_shared<TileMap>(
+		"space",
+		(mapWidth + tileSize - 1) / tileSize,
+		(mapHeight + tileSize - 1) / tileSize,
+		tileSize);
+
+	stars->fillWithTileset(tileset->width / tileSize, tileset->height / tileSize);
+
 	Entity background = registry->createEntity(tileMap);
-	background.addComponent<BackgroundComponent>("space", glm::vec2(0.0f, 0.0f), glm::vec2(mapWidth, mapHeight));
+	background.addComponent<TileMapComponent>(stars, 1.0f, true);
 }
 
 void Game::createPlayer() {
@@ -117,13 +173,22 @@ void Game::createPlayer() {
 	playerShip.addComponent<SpriteComponent>("player", glm::vec2(24, 36));
 	playerShip.addComponent<TransformComponent>(glm::vec2(startingX, centerY), glm::vec2(1.0f, 1.0f), 0.0f);
 	playerShip.addComponent<RigidBodyComponent>(glm::vec2(0.0f, 0.0f));
-	playerShip.addComponent<BoxColliderComponent>(24, 36);
+	playerShip.addComponent<BoxColliderComponent>(24, 36, glm::vec2(0, 0), CATEGORY_PLAYER);
 	playerShip.addComponent<ProjectileEmitterComponent>(80.0f, 300, 10000, 0.1f, true);
 	playerShip.addComponent<KeyboardControllerComponent>();
 	playerShip.addComponent<HealthComponent>();
 	playerShip.addComponent<TextLabelComponent>("digiBody", glm::vec2(0, 0), "100%", Color::GREEN);
 	playerShip.addComponent<LifeComponent>(3);
 	playerShip.addComponent<ExplosionComponent>();
+
+	ParticleEmission engineFire;
+	engineFire.lifetime = 0.2f;
+	engineFire.lifetimeVariance = 0.05f;
+	engineFire.speed = 60.0f;
+	engineFire.speedVariance = 15.0f;
+	engineFire.direction = 180.0f;
+	engineFire.spread = 8.0f;
+	playerShip.addComponent<ParticleEmitterComponent>("engineFire", 60.0f, glm::vec2(-12, 0), engineFire);
 	registry->setPlayerEntity(playerShip);
 
 }
@@ -131,13 +196,12 @@ void Game::createPlayer() {
 void Game::createHUDComponents() {
 
 	Entity title = registry->createEntity(gui);
-	TextLabelComponent textLabelComponent("digiBold", glm::vec2(centerX, 0.0f), "GALACTIC ASSAULT", Color::GREEN);
-	Helper::centerText(assetStore, renderer, textLabelComponent);
+	TextLabelComponent textLabelComponent("digiBold", glm::vec2(centerX, 0.0f), "GALACTIC ASSAULT", Color::GREEN, TextAlign::center);
 	title.addComponent<HUDComponent>(textLabelComponent, HUDComponent::HUDType::TITLE);
 
 	Entity points = registry->createEntity(gui);
-	TextLabelComponent pointTextLabelComponent("digiBold", glm::vec2(Game::windowWidth, 0.0f), "POINTS: 00", Color::GREEN);
-	Helper::alignRight(assetStore, renderer, pointTextLabelComponent);
+	// Right aligned every time it is drawn, so the points grow to the left
+	TextLabelComponent pointTextLabelComponent("digiBold", glm::vec2(Game::windowWidth, 0.0f), "POINTS: 00", Color::GREEN, TextAlign::right);
 	points.addComponent<HUDComponent>(pointTextLabelComponent, HUDComponent::HUDType::POINTS);
 
 	Entity lives = registry->createEntity(gui);
@@ -149,7 +213,10 @@ void Game::createHUDComponents() {
 
 void Game::addSystems() {
 
+	registry->addSystem<TransformHistorySystem>();
 	registry->addSystem<MovementSystem>();
+	registry->addSystem<SpatialIndexSystem>();
+	registry->addSystem<ViewportCullingSystem>();
 	registry->addSystem<RenderSystem>();
 	registry->addSystem<AnimationSystem>();
 	registry->addSystem<BoxColliderSystem>();
@@ -159,7 +226,7 @@ void Game::addSystems() {
 	registry->addSystem<AISystem>();
 	registry->addSystem<ProjectileSystem>();
 	registry->addSystem<ProjectilLifeTimeSystem>();
-	registry->addSystem<ScrollingBackgroundRenderSystem>();
+	registry->addSystem<TileMapSystem>();
 	registry->addSystem<EnemySpawnSystem>();
 	registry->addSystem<EnemyBoundsCheckingSystem>();
 	registry->addSystem<TextRenderSystem>();
@@ -176,6 +243,7 @@ void Game::addSystems() {
 	registry->addSystem<BackgroundMusicSystem>();
 	registry->addSystem<SoundEffectSystem>();
 	registry->addSystem<EngineSoundSystem>();
+	registry->addSystem<ParticleSystem>();
 }
 
 void Game::addTextures() {
@@ -194,9 +262,29 @@ void Game::addTextures() {
 	assetStore->addTexture(renderer, "playerLifeLost", "assets/images/playerLifeLost.png");
 }
 
+void Game::addParticleStyles() {
+
+	auto& particleSystem = registry->getSystem<ParticleSystem>();
+
+	// The explosion strips are four 32 by 32 frames
+	particleSystem.addStyle("explosionPlayer", { "playerExplosion", 32, 32, 4, glm::vec2(32, 32), 1.0f, false, false });
+	particleSystem.addStyle("explosionEnemy", { "enemyExplosion", 32, 32, 4, glm::vec2(32, 32), 1.0f, false, false });
+	particleSystem.addStyle("engineFire", { "engineFire", 31, 14, 1, glm::vec2(12, 6), 0.3f, true, true });
+	particleSystem.addStyle("sparkFriendly", { "playerLaser", 10, 2, 1, glm::vec2(6, 2), 0.5f, true, true });
+	particleSystem.addStyle("sparkEnemy", { "enemyLaser", 10, 2, 1, glm::vec2(6, 2), 0.5f, true, true });
+}
+
+void Game::addAnimationClips() {
+
+	auto& animationSystem = registry->getSystem<AnimationSystem>();
+
+	// Four 32 by 32 frames at 8 a second, played 7 times so the player is shielded for 3.5 seconds
+	animationSystem.addClip("shield", AnimationClip::fromStrip(32, 32, 4, 8, 7));
+}
+
 void Game::addFonts() {
-	assetStore->addFont("digiBody", "assets/fonts/DS-DIGI.TTF", 12);
-	assetStore->addFont("digiBold", "assets/fonts/DS-DIGIB.TTF", 32);
+	assetStore->addFont(renderer, "digiBody", "assets/fonts/DS-DIGI.TTF", 12);
+	assetStore->addFont(renderer, "digiBold", "assets/fonts/DS-DIGIB.TTF", 32);
 }
 
 void Game::addSounds() {
@@ -262,19 +350,67 @@ void Game::setupEventSubscriptions() {
 
 	auto& engineSoundSystem = registry->getSystem<EngineSoundSystem>();
 	engineSoundSystem.subscribeToEvent(eventBus);
+
+	auto& particleSystem = registry->getSystem<ParticleSystem>();
+	particleSystem.subscribeToEvent(eventBus);
+
+	auto& shieldSystem = registry->getSystem<ShieldSystem>();
+	shieldSystem.subscribeToEvent(eventBus);
 }
 
 void Game::run()
 {
-	msPreviousFrame = SDL_GetTicks();
+	// The simulation gets a thread of its own and hands every frame over as a snapshot.
+	// SDL stays on this thread, which created the window, so presenting never holds up the simulation
+	std::thread simulation(&Game::simulate, this);
+
+	while (isRunning)
+	{
+		pollEvents();
+
+		if (frames.acquire()) {
+			render(frames.getReadSlot());
+		}
+		else {
+			SDL_Delay(1);
+		}
+	}
+
+	simulation.join();
+};
+
+void Game::simulate()
+{
+	const double counterFrequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	uint64_t previousCounter = SDL_GetPerformanceCounter();
+	double accumulator = 0.0;
 
 	while (isRunning)
 	{
 		int start = SDL_GetTicks();
 
-		update(deltaTime);
-		processInput();
-		render();
+		const uint64_t counter = SDL_GetPerformanceCounter();
+		accumulator += (counter - previousCounter) / counterFrequency;
+		previousCounter = counter;
+
+		const double tickSeconds = 1.0 / tickRate;
+		int ticks = 0;
+
+		while (accumulator >= tickSeconds && ticks < MAX_CATCH_UP_TICKS) {
+			processInput();
+			update(static_cast<float>(tickSeconds));
+			accumulator -= tickSeconds;
+			ticks++;
+		}
+
+		// Too far behind to catch up, the game slows down instead of spiralling
+		if (accumulator >= tickSeconds) {
+			accumulator = std::fmod(accumulator, tickSeconds);
+		}
+
+		FrameSnapshot& frame = frames.getWriteSlot();
+		buildFrame(frame, static_cast<float>(accumulator / tickSeconds));
+		frames.publish();
 
 		int end = SDL_GetTicks();
 
@@ -285,14 +421,14 @@ void Game::run()
 		if (delayTime > 0) {
 			SDL_Delay(delayTime);
 		}
-
-		deltaTime = (SDL_GetTicks() - msPreviousFrame) / 1000.0f;
-
-		msPreviousFrame = SDL_GetTicks();
 	}
 };
 
-void Game::processInput() {
+void Game::setTickRate(int ticksPerSecond) {
+	tickRate = std::max(1, ticksPerSecond);
+}
+
+void Game::pollEvents() {
 
 	SDL_Event event;
 
@@ -301,68 +437,162 @@ void Game::processInput() {
 		case SDL_QUIT:
 			isRunning = false;
 			break;
-		case SDL_KEYDOWN:
-			eventBus->publishEvent<KeyboardEvent>(event.key.keysym.sym);
-
-			if (event.key.keysym.sym == SDLK_ESCAPE)
-			{
-				isRunning = false;
-			}
-			if (event.key.keysym.sym == SDLK_l)
-			{
-				isDebug = !isDebug;
-			}
-			if (event.key.keysym.sym == SDLK_SPACE)
-			{
-				eventBus->publishEvent<ProjectileEvent>(registry, event.key.keysym.sym);
-				eventBus->publishEvent<SoundEffectEvent>(assetStore, "playerLaser");
-			}
+		case SDL_RENDER_TARGETS_RESET:
+			hudRenderer.invalidate();
+			tileMapRenderer.invalidate();
+			break;
+		case SDL_RENDER_DEVICE_RESET:
+			hudRenderer.resetLayer();
+			tileMapRenderer.resetLayers();
+			break;
+		case SDL_KEYDOWN: {
+			std::lock_guard<std::mutex> lock(inputMutex);
+			pendingEvents.push_back(event);
 			break;
 		}
+		}
+	}
+}
+
+void Game::processInput() {
+
+	{
+		std::lock_guard<std::mutex> lock(inputMutex);
+		events.swap(pendingEvents);
+	}
+
+	for (const auto& event : events) {
+
+		eventBus->publishEvent<KeyboardEvent>(event.key.keysym.sym);
+
+		if (event.key.keysym.sym == SDLK_ESCAPE)
+		{
+			isRunning = false;
+		}
+		if (event.key.keysym.sym == SDLK_l)
+		{
+			isDebug = !isDebug;
+		}
+		if (isDebug && event.key.keysym.sym == SDLK_r)
+		{
+			registry->getSystem<BoxColliderSystem>().toggleRecording("colliders.rec");
+		}
+		if (isDebug && event.key.keysym.sym == SDLK_b)
+		{
+			auto& boxColliderSystem = registry->getSystem<BoxColliderSystem>();
+			boxColliderSystem.setBroadphase(static_cast<BroadphaseType>((boxColliderSystem.getBroadphaseType() + 1) % 3));
+		}
+		if (event.key.keysym.sym == SDLK_SPACE)
+		{
+			eventBus->publishEvent<ProjectileEvent>(registry, event.key.keysym.sym);
+			eventBus->publishEvent<SoundEffectEvent>(assetStore, "playerLaser");
+		}
 	}
+
+	events.clear();
 }
 
 
 void Game::update(float deltaTime) {
+	SimulationClock::advance(deltaTime);
 	registry->update();
+	registry->getSystem<TransformHistorySystem>().update();
+	registry->getSystem<TileMapSystem>().scroll(deltaTime);
 	registry->getSystem<MovementSystem>().update(deltaTime);
+	registry->getSystem<SpatialIndexSystem>().update();
 	registry->getSystem<AISystem>().update(eventBus, registry, assetStore, Game::mapWidth);
 	registry->getSystem<AnimationSystem>().animate(eventBus, registry);
 	registry->getSystem<ProjectilLifeTimeSystem>().update();
-	registry->getSystem<BoxColliderSystem>().update(eventBus, registry, assetStore);
+	registry->getSystem<BoxColliderSystem>().update(eventBus, registry, assetStore, workerPool);
 	registry->getSystem<ShieldSystem>().update();
 	registry->getSystem<EnemySpawnSystem>().update(registry, eventBus, assetStore, Game::mapWidth, Game::mapHeight - Game::mapOffset);
 	registry->getSystem<EnemyBoundsCheckingSystem>().update();
 	registry->getSystem<DynamicTextSystem>().update();
 	registry->getSystem<PointSystem>().update();
 	registry->getSystem<HUDLifeUpdateSystem>().update(registry);
+	registry->getSystem<ParticleSystem>().update(deltaTime);
 	
 };
 
-void Game::render() {
+void Game::buildFrame(FrameSnapshot& frame, float alpha) {
 
-	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-	SDL_RenderClear(renderer);
+	// The slot may still hold a frame the renderer never took
+	frame.clear();
+
+	registry->getSystem<TileMapSystem>().update(frame.tileMaps, Game::mapOffset, alpha);
 
-	registry->getSystem<ScrollingBackgroundRenderSystem>().update(renderer, assetStore, deltaTime, Game::mapOffset);
+	// The world is drawn mapOffset further down, so the screen shows it from -mapOffset
+	const SDL_FRect viewport{
+		0.0f,
+		static_cast<float>(-Game::mapOffset),
+		static_cast<float>(Game::windowWidth),
+		static_cast<float>(Game::windowHeight)
+	};
 
-	registry->getSystem<RenderSystem>().update(renderer, assetStore, Game::mapOffset);
+	auto& cullingSystem = registry->getSystem<ViewportCullingSystem>();
+	cullingSystem.update(registry, viewport);
+	const auto& visibleEntities = cullingSystem.getVisibleEntities();
+
+	registry->getSystem<RenderSystem>().update(frame.world, assetStore, visibleEntities, Game::mapOffset, alpha);
+
+	registry->getSystem<ParticleSystem>().submit(frame.world, assetStore, Game::mapOffset, alpha);
 
 	if (isDebug) {
-		registry->getSystem<DebugBoxCollisionRenderer>().update(renderer, Game::mapOffset);
+		registry->getSystem<DebugBoxCollisionRenderer>().update(frame.world, visibleEntities, Game::mapOffset, alpha);
 	}
 
-	registry->getSystem<HealthBarRenderSystem>().update(renderer, Game::mapOffset);
+	registry->getSystem<HealthBarRenderSystem>().update(frame.world, visibleEntities, Game::mapOffset, alpha);
+
+	registry->getSystem<TextRenderSystem>().update(frame.world, assetStore, visibleEntities, Game::mapOffset, alpha);
+
+	registry->getSystem<HUDRenderSystem>().update(frame.hud, *assetStore);
+};
+
+void Game::render(FrameSnapshot& frame) {
+
+	if (rasterizer) {
+		renderSoftware(frame);
+		return;
+	}
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+
+	// Tile maps go first, then the world sorted by pass, layer and texture, and the HUD over it
+	tileMapRenderer.draw(*assetStore, renderer, frame.tileMaps, SDL_Rect{ 0, 0, Game::windowWidth, Game::windowHeight });
 
-	registry->getSystem<TextRenderSystem>().update(renderer, assetStore, Game::mapOffset);
+	frame.world.flush(renderer);
 
-	registry->getSystem<HUDRenderSystem>().update(assetStore, renderer);
+	hudRenderer.draw(*assetStore, renderer, frame.hud);
 	
 	SDL_RenderPresent(renderer);
 };
 
+void Game::renderSoftware(FrameSnapshot& frame) {
+
+	rasterizer->clear(SDL_Color{ 0, 0, 0, 255 });
+
+	// Without render targets to cache in, tile maps and the HUD go through the queue with everything else
+	tileMapRenderer.submit(frame.world, *assetStore, frame.tileMaps, SDL_Rect{ 0, 0, Game::windowWidth, Game::windowHeight });
+	hudRenderer.submit(frame.world, *assetStore, frame.hud);
+
+	frame.world.flush(*rasterizer);
+
+	if (SDL_UpdateTexture(framebuffer, NULL, rasterizer->getPixels(), rasterizer->getWidth() * 4) != 0) {
+		Logger::LogErr(SDL_GetError());
+	}
+
+	SDL_RenderCopy(renderer, framebuffer, NULL, NULL);
+	SDL_RenderPresent(renderer);
+}
+
 void Game::destroy()
 {
+	if (framebuffer != nullptr) {
+		SDL_DestroyTexture(framebuffer);
+		framebuffer = nullptr;
+	}
+
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	SDL_Quit();
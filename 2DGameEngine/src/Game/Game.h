@@ -2,22 +2,39 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <glm/glm.hpp>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include "../ECS/ESC.h"
 #include "../Assets/AssetStore.h"
 #include "../Events/EventBus.h"
+#include "../Threading/WorkerPool.h"
+#include "../Threading/TripleBuffer.h"
+#include "../Render/FrameSnapshot.h"
+#include "../Render/HUDRenderer.h"
+#include "../Render/TileMapRenderer.h"
+#include "../Render/SoftwareRasterizer.h"
 
 const int FPS = 120;
 const int MILLISECS_PER_FRAME = 1000 / FPS;
 
+// Simulation ticks per second, independent of how often frames are drawn
+const int TICK_RATE = 60;
+// Ticks run at most per frame to catch up, time past that is dropped
+const int MAX_CATCH_UP_TICKS = 5;
+
 class Game {
 
 private:
-	bool isRunning;
-	int msPreviousFrame;
-	float deltaTime;
+	std::atomic<bool> isRunning;
+	// Can be changed from another thread while the simulation runs
+	std::atomic<int> tickRate;
 	float centerX;
 	float centerY;
 
+	// Draws every frame with the software rasterizer, for machines without a usable GPU
+	const bool isSoftwareRendering;
+
 	SDL_DisplayMode displayMode;
 	SDL_Window* window;
 	SDL_Renderer* renderer;
@@ -25,12 +42,30 @@ private:
 	std::unique_ptr<Registry> registry;
 	std::unique_ptr<AssetStore> assetStore;
 	std::unique_ptr<EventBus> eventBus;
+	std::unique_ptr<WorkerPool> workerPool;
+
+	// Frames go from the simulation thread to the thread that owns the renderer
+	TripleBuffer<FrameSnapshot> frames;
+	HUDRenderer hudRenderer;
+	TileMapRenderer tileMapRenderer;
+
+	// Only made when rendering in software. The rasterizer has its own workers, the shared pool belongs to the simulation thread
+	std::unique_ptr<WorkerPool> rasterizerPool;
+	std::unique_ptr<SoftwareRasterizer> rasterizer;
+	SDL_Texture* framebuffer = nullptr;
+
+	// Key presses polled on the main thread, waiting for the simulation to take them
+	std::mutex inputMutex;
+	std::vector<SDL_Event> pendingEvents;
+	std::vector<SDL_Event> events;
 
 	void setCenterValues();
 	void loadLevel(int level);
 	void setupEventSubscriptions();
 	void addSystems();
 	void addTextures();
+	void addParticleStyles();
+	void addAnimationClips();
 	void addFonts();
 	void addSounds();
 	void createBackground();
@@ -38,11 +73,13 @@ private:
 	void createHUDComponents();
 	void playBackgroundMusic();
 	void startEngineSound();
+	void createSoftwareRasterizer();
+	void renderSoftware(FrameSnapshot& frame);
 
 	bool isDebug;
 
 public:
-	Game();
+	Game(bool isSoftwareRendering = false);
 	~Game();
 
 	static int windowWidth;
@@ -52,9 +89,15 @@ public:
 	static int mapOffset;
 
 	void run();
+	void simulate();
+	void pollEvents();
 	void processInput();
 	void update(float deltaTime);
-	void render();
+	// alpha is how far the frame lies between the previous tick and the current one
+	void buildFrame(FrameSnapshot& frame, float alpha);
+
+	void setTickRate(int ticksPerSecond);
+	void render(FrameSnapshot& frame);
 	void destroy();
 	void setup();
 };
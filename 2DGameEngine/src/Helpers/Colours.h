@@ -1,9 +1,10 @@
 #pragma once
 #include <SDL.h>
 
+// Opaque, text is tinted through vertex colours and those use the alpha
 struct Color {
-	static constexpr SDL_Color WHITE{ 255, 255, 255 };
-	static constexpr SDL_Color GREEN{ 0, 255, 0 };
-	static constexpr SDL_Color RED{ 255, 0, 0 };
-	static constexpr SDL_Color ORANGE{ 255, 165, 0 };
+	static constexpr SDL_Color WHITE{ 255, 255, 255, 255 };
+	static constexpr SDL_Color GREEN{ 0, 255, 0, 255 };
+	static constexpr SDL_Color RED{ 255, 0, 0, 255 };
+	static constexpr SDL_Color ORANGE{ 255, 165, 0, 255 };
 };
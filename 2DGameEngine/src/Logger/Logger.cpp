@@ -4,15 +4,18 @@
 #include "../../libs/date/date.h" 
 
 std::vector<LogEntry> Logger::logEntries;
+std::mutex Logger::mutex;
 
 void Logger::Log(const std::string& message)
 {
+	std::lock_guard<std::mutex> lock(mutex);
 	addLogEntry(LOG_MESSAGE, message);
 	std::cout << "\033[32m" << " LOG: [" << time() << "] " << message << "\033[0m" << std::endl;
 };
 
 void Logger::LogErr(const std::string& message)
 {
+	std::lock_guard<std::mutex> lock(mutex);
 	addLogEntry(LOG_ERROR, message);
 	std::cout << "\033[31m" << "LOG: [" << time() << "] " << message << "\033[0m" << std::endl;
 };
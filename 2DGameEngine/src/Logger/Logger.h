@@ -1,4 +1,5 @@
 #pragma once
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -17,6 +18,8 @@ class Logger {
 
 private:
 	static std::vector<LogEntry> logEntries;
+	// The simulation and the renderer log from different threads
+	static std::mutex mutex;
 	static std::string time();
 	static void addLogEntry(LogType logType, const std::string& message);
 
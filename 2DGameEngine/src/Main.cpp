@@ -1,11 +1,21 @@
 #include <iostream>
+#include <cstring>
 #include "./Game/Game.h"
 
 int main(int argc, char* argv[]) {
 
-	Game game;
+	// --software draws with the software rasterizer instead of the GPU
+	bool isSoftwareRendering = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--software") == 0) {
+			isSoftwareRendering = true;
+		}
+	}
+
+	Game game(isSoftwareRendering);
 
 	game.run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,14 @@
+#include "Affine2D.h"
+
+void Affine2D::applyToPoints(const float* pointsX, const float* pointsY, float* outX, float* outY, int count) const {
+
+	for (int i = 0; i < count; i++) {
+
+		// Both read before either is written, so transforming in place is safe
+		const float pointX = pointsX[i];
+		const float pointY = pointsY[i];
+
+		outX[i] = a * pointX + b * pointY + x;
+		outY[i] = c * pointX + d * pointY + y;
+	}
+}
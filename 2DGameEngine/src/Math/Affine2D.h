@@ -0,0 +1,65 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "Trig.h"
+
+/// <summary>
+/// A 2D affine transform as the top two rows of a 3x3 matrix:
+///   | a  b  x |
+///   | c  d  y |
+/// Applying one to a point is four multiply-adds, where a glm::mat4 does
+/// sixteen and a chain of them three times that
+/// </summary>
+struct Affine2D {
+
+	float a = 1.0f;
+	float b = 0.0f;
+	float c = 0.0f;
+	float d = 1.0f;
+	float x = 0.0f;
+	float y = 0.0f;
+
+	static Affine2D translation(glm::vec2 offset) {
+		return Affine2D{ 1.0f, 0.0f, 0.0f, 1.0f, offset.x, offset.y };
+	}
+
+	// With y pointing down a positive angle turns clockwise, like the transform rotation
+	static Affine2D rotation(SinCos turn) {
+		return Affine2D{ turn.cosine, -turn.sine, turn.sine, turn.cosine, 0.0f, 0.0f };
+	}
+
+	// Turns about centre instead of the origin
+	static Affine2D rotationAbout(glm::vec2 centre, SinCos turn) {
+		return Affine2D{
+			turn.cosine,
+			-turn.sine,
+			turn.sine,
+			turn.cosine,
+			centre.x - turn.cosine * centre.x + turn.sine * centre.y,
+			centre.y - turn.sine * centre.x - turn.cosine * centre.y
+		};
+	}
+
+	// This after other, so other is applied first
+	Affine2D operator *(const Affine2D& other) const {
+		return Affine2D{
+			a * other.a + b * other.c,
+			a * other.b + b * other.d,
+			c * other.a + d * other.c,
+			c * other.b + d * other.d,
+			a * other.x + b * other.y + x,
+			c * other.x + d * other.y + y
+		};
+	}
+
+	glm::vec2 apply(glm::vec2 point) const {
+		return glm::vec2(a * point.x + b * point.y + x, c * point.x + d * point.y + y);
+	}
+
+	// Leaves out the translation, for directions and velocities
+	glm::vec2 applyToVector(glm::vec2 vector) const {
+		return glm::vec2(a * vector.x + b * vector.y, c * vector.x + d * vector.y);
+	}
+
+	// Applies the transform to count points held as separate x and y arrays. The output may be the input
+	void applyToPoints(const float* pointsX, const float* pointsY, float* outX, float* outY, int count) const;
+};
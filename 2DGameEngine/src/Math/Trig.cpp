@@ -0,0 +1,85 @@
+#include "Trig.h"
+#include <cmath>
+
+namespace {
+	constexpr float PI = 3.14159265358979f;
+	constexpr float DEGREES_PER_RADIAN = 180.0f / PI;
+}
+
+const float* Trig::getSineTable() {
+
+	// A quarter turn more than a full one so cosine reads the same table a quarter ahead,
+	// and one more so interpolation never reads past the end
+	static const struct SineTable {
+		float values[TABLE_SIZE + TABLE_SIZE / 4 + 1];
+
+		SineTable() {
+			for (int i = 0; i < TABLE_SIZE + TABLE_SIZE / 4 + 1; i++) {
+				values[i] = static_cast<float>(std::sin(2.0 * 3.14159265358979323846 * i / TABLE_SIZE));
+			}
+		}
+	} table;
+
+	return table.values;
+}
+
+SinCos Trig::sinCos(float degrees) {
+
+	const float radians = degrees / DEGREES_PER_RADIAN;
+
+	return SinCos{ std::sin(radians), std::cos(radians) };
+}
+
+SinCos Trig::fastSinCos(float degrees) {
+
+	const float* table = getSineTable();
+
+	float turns = degrees * (1.0f / 360.0f);
+	turns -= std::floor(turns);
+
+	// Tiny negative angles round up to a whole turn, which is the same as none. NaN and infinity read the first entry
+	if (!(turns >= 0.0f && turns < 1.0f)) {
+		turns = 0.0f;
+	}
+
+	const float position = turns * TABLE_SIZE;
+	const int index = static_cast<int>(position);
+	const float fraction = position - static_cast<float>(index);
+
+	const float* sine = table + index;
+	const float* cosine = table + index + TABLE_SIZE / 4;
+
+	return SinCos{
+		sine[0] + (sine[1] - sine[0]) * fraction,
+		cosine[0] + (cosine[1] - cosine[0]) * fraction
+	};
+}
+
+float Trig::fastAngleOf(float x, float y) {
+
+	const float absX = std::fabs(x);
+	const float absY = std::fabs(y);
+	const float largest = std::fmax(absX, absY);
+
+	if (largest == 0.0f) {
+		return 0.0f;
+	}
+
+	// atan on 0 to 1, then mirrored into the right octant
+	const float ratio = std::fmin(absX, absY) / largest;
+	const float square = ratio * ratio;
+
+	float radians = ((-0.0464964749f * square + 0.15931422f) * square - 0.327622764f) * square * ratio + ratio;
+
+	radians = absY > absX ? PI * 0.5f - radians : radians;
+	radians = x < 0.0f ? PI - radians : radians;
+	radians = y < 0.0f ? -radians : radians;
+
+	return radians * DEGREES_PER_RADIAN;
+}
+
+void Trig::fastAnglesOf(const float* x, const float* y, float* degrees, int count) {
+	for (int i = 0; i < count; i++) {
+		degrees[i] = fastAngleOf(x[i], y[i]);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <glm/glm.hpp>
+
+struct SinCos {
+	float sine;
+	float cosine;
+};
+
+/// <summary>
+/// Sine, cosine and angles in degrees, the unit the transforms use. The fast
+/// versions read a table or a polynomial instead of calling the maths
+/// library, close enough to aim and move with but not for anything exact
+/// </summary>
+class Trig {
+
+private:
+
+	// Table entries per turn, the error of the interpolation between them is about 5e-6
+	static constexpr int TABLE_SIZE = 1024;
+
+	static const float* getSineTable();
+
+public:
+
+	static SinCos sinCos(float degrees);
+
+	// From the table, interpolated between entries
+	static SinCos fastSinCos(float degrees);
+
+	// Angle of a direction in degrees from -180 to 180, clockwise from +x with y pointing down.
+	// A polynomial accurate to about 0.01 degrees, 0 for a zero direction
+	static float fastAngleOf(float x, float y);
+
+	static float fastAngleOf(glm::vec2 direction) {
+		return fastAngleOf(direction.x, direction.y);
+	}
+
+	// fastAngleOf for count directions at once
+	static void fastAnglesOf(const float* x, const float* y, float* degrees, int count);
+};
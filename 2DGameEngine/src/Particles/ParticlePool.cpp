@@ -0,0 +1,128 @@
+#include "ParticlePool.h"
+#include <algorithm>
+
+ParticlePool::ParticlePool(int capacity) :
+	capacity(capacity),
+	positionX(capacity),
+	positionY(capacity),
+	velocityX(capacity),
+	velocityY(capacity),
+	age(capacity),
+	lifetime(capacity),
+	drag(capacity),
+	rotation(capacity),
+	styles(capacity) {
+}
+
+bool ParticlePool::spawn(const ParticleSpawn& particle) {
+
+	if (count == capacity) {
+		return false;
+	}
+
+	positionX[count] = particle.x;
+	positionY[count] = particle.y;
+	velocityX[count] = particle.velocityX;
+	velocityY[count] = particle.velocityY;
+	age[count] = 0.0f;
+	lifetime[count] = particle.lifetime;
+	drag[count] = particle.drag;
+	rotation[count] = particle.rotation;
+	styles[count] = particle.style;
+	count++;
+
+	return true;
+}
+
+void ParticlePool::moveParticle(int from, int to) {
+	positionX[to] = positionX[from];
+	positionY[to] = positionY[from];
+	velocityX[to] = velocityX[from];
+	velocityY[to] = velocityY[from];
+	age[to] = age[from];
+	lifetime[to] = lifetime[from];
+	drag[to] = drag[from];
+	rotation[to] = rotation[from];
+	styles[to] = styles[from];
+}
+
+void ParticlePool::update(float deltaTime) {
+
+	float* x = positionX.data();
+	float* y = positionY.data();
+	float* vx = velocityX.data();
+	float* vy = velocityY.data();
+	float* ages = age.data();
+	const float* drags = drag.data();
+
+	// No branches and one array per stream, so each loop becomes SIMD
+	for (int i = 0; i < count; i++) {
+		const float damping = std::max(0.0f, 1.0f - drags[i] * deltaTime);
+		vx[i] *= damping;
+		vy[i] *= damping;
+	}
+
+	for (int i = 0; i < count; i++) {
+		x[i] += vx[i] * deltaTime;
+		y[i] += vy[i] * deltaTime;
+	}
+
+	for (int i = 0; i < count; i++) {
+		ages[i] += deltaTime;
+	}
+
+	// The last live particle takes the place of a dead one, the order does not matter
+	for (int i = 0; i < count; ) {
+		if (ages[i] >= lifetime[i]) {
+			count--;
+			moveParticle(count, i);
+		}
+		else {
+			i++;
+		}
+	}
+}
+
+void ParticlePool::clear() {
+	count = 0;
+}
+
+int ParticlePool::size() const {
+	return count;
+}
+
+int ParticlePool::getCapacity() const {
+	return capacity;
+}
+
+const float* ParticlePool::getPositionX() const {
+	return positionX.data();
+}
+
+const float* ParticlePool::getPositionY() const {
+	return positionY.data();
+}
+
+const float* ParticlePool::getVelocityX() const {
+	return velocityX.data();
+}
+
+const float* ParticlePool::getVelocityY() const {
+	return velocityY.data();
+}
+
+const float* ParticlePool::getAge() const {
+	return age.data();
+}
+
+const float* ParticlePool::getLifetime() const {
+	return lifetime.data();
+}
+
+const float* ParticlePool::getRotation() const {
+	return rotation.data();
+}
+
+const uint16_t* ParticlePool::getStyles() const {
+	return styles.data();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// How particles leave an emitter. Angles are in degrees, clockwise from +x
+/// like the transform rotation, and spread is how far either side of the
+/// direction a particle may go
+/// </summary>
+struct ParticleEmission {
+	float lifetime = 0.5f;
+	float lifetimeVariance = 0.0f;
+	float speed = 0.0f;
+	float speedVariance = 0.0f;
+	float direction = 0.0f;
+	float spread = 180.0f;
+	// Part of the velocity lost every second
+	float drag = 0.0f;
+};
+
+struct ParticleSpawn {
+	float x;
+	float y;
+	float velocityX;
+	float velocityY;
+	float lifetime;
+	float drag;
+	float rotation;
+	uint16_t style;
+};
+
+/// <summary>
+/// A fixed number of particles kept as structure of arrays. Live particles
+/// are packed at the front, so the update is a few straight loops over
+/// floats the compiler can vectorise, and a dead particle is replaced by
+/// the last live one
+/// </summary>
+class ParticlePool {
+
+private:
+
+	int capacity = 0;
+	int count = 0;
+
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> age;
+	std::vector<float> lifetime;
+	std::vector<float> drag;
+	std::vector<float> rotation;
+	std::vector<uint16_t> styles;
+
+	void moveParticle(int from, int to);
+
+public:
+
+	explicit ParticlePool(int capacity = 8192);
+
+	// False when the pool is full, the particle is then dropped
+	bool spawn(const ParticleSpawn& particle);
+
+	// Moves every particle on and removes the ones that have lived out their lifetime
+	void update(float deltaTime);
+
+	void clear();
+
+	int size() const;
+	int getCapacity() const;
+
+	const float* getPositionX() const;
+	const float* getPositionY() const;
+	const float* getVelocityX() const;
+	const float* getVelocityY() const;
+	const float* getAge() const;
+	const float* getLifetime() const;
+	const float* getRotation() const;
+	const uint16_t* getStyles() const;
+};
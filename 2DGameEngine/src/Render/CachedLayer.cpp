@@ -0,0 +1,88 @@
+#include "CachedLayer.h"
+#include "../Logger/Logger.h"
+
+bool CachedLayer::begin(SDL_Renderer* renderer, const SDL_Rect& bounds) {
+
+	if (bounds.w <= 0 || bounds.h <= 0) {
+		return false;
+	}
+
+	const bool isResized = texture == nullptr || bounds.w != this->bounds.w || bounds.h != this->bounds.h;
+
+	if (!isDirty && !isResized && bounds.x == this->bounds.x && bounds.y == this->bounds.y) {
+		return false;
+	}
+
+	if (isResized) {
+
+		destroy();
+
+		texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, bounds.w, bounds.h);
+
+		if (texture == nullptr) {
+			Logger::LogErr(SDL_GetError());
+			return false;
+		}
+
+		// Drawing into a cleared target leaves its colours multiplied by their alpha,
+		// so the layer is blended as premultiplied to keep the edges of text from darkening
+		const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+		if (SDL_SetTextureBlendMode(texture, premultiplied) != 0) {
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		}
+	}
+
+	this->bounds = bounds;
+	previousTarget = SDL_GetRenderTarget(renderer);
+
+	if (SDL_SetRenderTarget(renderer, texture) != 0) {
+		Logger::LogErr(SDL_GetError());
+		return false;
+	}
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	return true;
+}
+
+void CachedLayer::end(SDL_Renderer* renderer) {
+	SDL_SetRenderTarget(renderer, previousTarget);
+	previousTarget = nullptr;
+	isDirty = false;
+}
+
+void CachedLayer::draw(SDL_Renderer* renderer) const {
+
+	if (texture == nullptr) {
+		return;
+	}
+
+	SDL_RenderCopy(renderer, texture, NULL, &bounds);
+}
+
+void CachedLayer::draw(SDL_Renderer* renderer, const SDL_FRect& dstRect) const {
+
+	if (texture == nullptr) {
+		return;
+	}
+
+	SDL_RenderCopyF(renderer, texture, NULL, &dstRect);
+}
+
+void CachedLayer::invalidate() {
+	isDirty = true;
+}
+
+void CachedLayer::destroy() {
+
+	if (texture != nullptr) {
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+
+	isDirty = true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <SDL.h>
+
+/// <summary>
+/// Part of the screen drawn once into its own render target and copied to
+/// the screen every frame after that. It is only drawn again once it has
+/// been invalidated or its bounds change
+/// </summary>
+class CachedLayer {
+
+private:
+
+	SDL_Texture* texture = nullptr;
+	SDL_Rect bounds{ 0, 0, 0, 0 };
+	bool isDirty = true;
+	// The target that was set when begin ran, put back by end
+	SDL_Texture* previousTarget = nullptr;
+
+public:
+
+	CachedLayer() = default;
+
+	// True when the layer has to be drawn again. The render target is then set to
+	// the cleared layer, which the caller draws into offset by -bounds.x, -bounds.y,
+	// and finishes with end, which restores the target that was set before
+	bool begin(SDL_Renderer* renderer, const SDL_Rect& bounds);
+	void end(SDL_Renderer* renderer);
+
+	// Copies the layer to the current render target
+	void draw(SDL_Renderer* renderer) const;
+	// Copies the layer to dstRect instead of its bounds
+	void draw(SDL_Renderer* renderer, const SDL_FRect& dstRect) const;
+
+	// The inputs of the layer changed, or the renderer lost the contents of its targets
+	void invalidate();
+
+	// Frees the texture, for when the renderer lost its textures altogether
+	void destroy();
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+#include "RenderQueue.h"
+#include "HUDRenderer.h"
+#include "TileMapRenderer.h"
+
+/// <summary>
+/// Everything needed to draw one frame, copied out of the ECS by the
+/// simulation so the renderer never reads a component
+/// </summary>
+struct FrameSnapshot {
+	// Tile map layers behind the world, farthest first
+	std::vector<TileMapView> tileMaps;
+	// Sprites, text runs and rectangles of the world
+	RenderQueue world;
+	std::vector<HUDElement> hud;
+
+	void clear() {
+		tileMaps.clear();
+		world.clear();
+		hud.clear();
+	}
+};
@@ -0,0 +1,157 @@
+#include "HUDRenderer.h"
+#include "../ECS/ESC.h"
+#include <algorithm>
+#include <cmath>
+
+SDL_Rect HUDRenderer::measureBounds(const AssetStore& assetStore, const std::vector<HUDElement>& elements) const {
+
+	int minX = 0;
+	int minY = 0;
+	int maxX = 0;
+	int maxY = 0;
+	bool isEmpty = true;
+
+	for (const auto& element : elements) {
+
+		glm::vec2 size = element.size;
+
+		if (!element.text.empty()) {
+			const GlyphAtlas* glyphAtlas = assetStore.getGlyphAtlas(element.assetid);
+			if (glyphAtlas == nullptr) {
+				continue;
+			}
+			size = glm::vec2(glyphAtlas->measure(element.text), glyphAtlas->getLineHeight());
+		}
+
+		const int left = static_cast<int>(std::floor(element.position.x));
+		const int top = static_cast<int>(std::floor(element.position.y));
+		const int right = static_cast<int>(std::ceil(element.position.x + size.x));
+		const int bottom = static_cast<int>(std::ceil(element.position.y + size.y));
+
+		minX = isEmpty ? left : std::min(minX, left);
+		minY = isEmpty ? top : std::min(minY, top);
+		maxX = isEmpty ? right : std::max(maxX, right);
+		maxY = isEmpty ? bottom : std::max(maxY, bottom);
+		isEmpty = false;
+	}
+
+	return SDL_Rect{ minX, minY, maxX - minX, maxY - minY };
+}
+
+void HUDRenderer::drawElements(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<HUDElement>& elements, glm::vec2 origin) {
+
+	for (const auto& element : elements) {
+
+		if (!element.text.empty()) {
+
+			const GlyphAtlas* glyphAtlas = assetStore.getGlyphAtlas(element.assetid);
+
+			if (glyphAtlas != nullptr) {
+				textBatcher.addText(
+					*glyphAtlas,
+					element.text,
+					static_cast<int>(element.position.x + origin.x),
+					static_cast<int>(element.position.y + origin.y),
+					element.color);
+			}
+		}
+		else {
+
+			const TextureInfo* textureInfo = assetStore.getTextureInfo(element.assetid);
+
+			if (textureInfo == nullptr) {
+				continue;
+			}
+
+			const SDL_Rect srcRect = textureInfo->getSource({
+				0,
+				0,
+				static_cast<int>(element.size.x),
+				static_cast<int>(element.size.y)
+			});
+
+			SDL_FRect dstRect = {
+				element.position.x + origin.x,
+				element.position.y + origin.y,
+				element.size.x,
+				element.size.y
+			};
+
+			SDL_RenderCopyExF(
+				renderer,
+				textureInfo->texture,
+				&srcRect,
+				&dstRect,
+				0,
+				NULL,
+				SDL_FLIP_NONE);
+		}
+	}
+
+	textBatcher.flush(renderer);
+}
+
+void HUDRenderer::draw(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<HUDElement>& elements) {
+
+	if (!SDL_RenderTargetSupported(renderer)) {
+		drawElements(assetStore, renderer, elements, glm::vec2(0, 0));
+		return;
+	}
+
+	// The HUD changes a few times a minute, so most frames only copy the cached layer
+	if (!(elements == drawnElements)) {
+		drawnElements = elements;
+		layerBounds = measureBounds(assetStore, elements);
+		hudLayer.invalidate();
+	}
+
+	if (hudLayer.begin(renderer, layerBounds)) {
+		drawElements(assetStore, renderer, elements, glm::vec2(-layerBounds.x, -layerBounds.y));
+		hudLayer.end(renderer);
+	}
+
+	hudLayer.draw(renderer);
+}
+
+void HUDRenderer::submit(RenderQueue& renderQueue, const AssetStore& assetStore, const std::vector<HUDElement>& elements) const {
+
+	for (const auto& element : elements) {
+
+		if (!element.text.empty()) {
+
+			const GlyphAtlas* glyphAtlas = assetStore.getGlyphAtlas(element.assetid);
+
+			if (glyphAtlas != nullptr) {
+				renderQueue.submitText(
+					RenderPass::hud,
+					Layer::gui,
+					*glyphAtlas,
+					element.text,
+					static_cast<float>(static_cast<int>(element.position.x)),
+					static_cast<float>(static_cast<int>(element.position.y)),
+					element.color);
+			}
+		}
+		else {
+
+			const TextureInfo* textureInfo = assetStore.getTextureInfo(element.assetid);
+
+			if (textureInfo == nullptr) {
+				continue;
+			}
+
+			const SDL_Rect srcRect{ 0, 0, static_cast<int>(element.size.x), static_cast<int>(element.size.y) };
+			const SDL_FRect dstRect{ element.position.x, element.position.y, element.size.x, element.size.y };
+
+			renderQueue.submitSprite(RenderPass::hud, Layer::gui, *textureInfo, srcRect, dstRect, 0.0f);
+		}
+	}
+}
+
+void HUDRenderer::invalidate() {
+	hudLayer.invalidate();
+}
+
+void HUDRenderer::resetLayer() {
+	hudLayer.destroy();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "../Assets/AssetStore.h"
+#include "TextBatcher.h"
+#include "CachedLayer.h"
+#include "RenderQueue.h"
+
+/// <summary>
+/// What one HUD element is drawn from: text when text is set, the image
+/// asset otherwise. The simulation copies these into every frame snapshot
+/// </summary>
+struct HUDElement {
+	std::string assetid;
+	std::string text;
+	SDL_Color color;
+	glm::vec2 position;
+	glm::vec2 size;
+
+	bool operator ==(const HUDElement& other) const {
+		return assetid == other.assetid &&
+			text == other.text &&
+			color.r == other.color.r && color.g == other.color.g && color.b == other.color.b && color.a == other.color.a &&
+			position == other.position &&
+			size == other.size;
+	}
+};
+
+/// <summary>
+/// Draws the HUD elements of a snapshot into a cached layer, which is only
+/// drawn again when the elements change. Lives with the renderer
+/// </summary>
+class HUDRenderer {
+
+private:
+
+	TextBatcher textBatcher;
+	CachedLayer hudLayer;
+	SDL_Rect layerBounds{ 0, 0, 0, 0 };
+	std::vector<HUDElement> drawnElements;
+
+	SDL_Rect measureBounds(const AssetStore& assetStore, const std::vector<HUDElement>& elements) const;
+	void drawElements(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<HUDElement>& elements, glm::vec2 origin);
+
+public:
+
+	HUDRenderer() = default;
+
+	void draw(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<HUDElement>& elements);
+
+	// Queues the elements above everything else instead of caching them, for the software rasterizer
+	void submit(RenderQueue& renderQueue, const AssetStore& assetStore, const std::vector<HUDElement>& elements) const;
+
+	// The renderer lost what was drawn into its targets
+	void invalidate();
+
+	// The renderer lost its textures altogether
+	void resetLayer();
+};
@@ -0,0 +1,335 @@
+#include "RenderQueue.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+uint32_t RenderQueue::getStateKey(uint64_t state) {
+
+	auto stateKey = stateKeys.find(state);
+
+	if (stateKey != stateKeys.end()) {
+		return stateKey->second;
+	}
+
+	// Keys only group commands, handing them out again from zero is always safe
+	if (stateKeys.size() >= (1u << STATE_BITS)) {
+		stateKeys.clear();
+	}
+
+	const uint32_t key = static_cast<uint32_t>(stateKeys.size());
+	stateKeys.emplace(state, key);
+
+	return key;
+}
+
+void RenderQueue::push(RenderPass pass, int layer, uint16_t depth, uint64_t state, const RenderCommand& command) {
+
+	const uint64_t sequence = commands.size() & ((1u << SEQUENCE_BITS) - 1);
+	const uint64_t clampedLayer = static_cast<uint64_t>(std::min(std::max(layer, 0), (1 << LAYER_BITS) - 1));
+
+	const uint64_t key =
+		(static_cast<uint64_t>(pass) << (LAYER_BITS + DEPTH_BITS + STATE_BITS + SEQUENCE_BITS)) |
+		(clampedLayer << (DEPTH_BITS + STATE_BITS + SEQUENCE_BITS)) |
+		(static_cast<uint64_t>(depth) << (STATE_BITS + SEQUENCE_BITS)) |
+		(static_cast<uint64_t>(getStateKey(state)) << SEQUENCE_BITS) |
+		sequence;
+
+	entries.push_back({ key, static_cast<uint32_t>(commands.size()) });
+	commands.push_back(command);
+}
+
+void RenderQueue::submitSprite(RenderPass pass, int layer, const TextureInfo& texture, const SDL_Rect& srcRect, const SDL_FRect& dstRect, float rotation, SDL_Color color, uint16_t depth) {
+
+	if (texture.texture == nullptr || texture.textureWidth == 0 || texture.textureHeight == 0) {
+		return;
+	}
+
+	// The image may be one of many in an atlas
+	const SDL_Rect source = texture.getSource(srcRect);
+
+	RenderCommand command;
+	command.type = RenderCommandType::sprite;
+	command.texture = texture.texture;
+	command.left = static_cast<float>(source.x) / texture.textureWidth;
+	command.top = static_cast<float>(source.y) / texture.textureHeight;
+	command.right = static_cast<float>(source.x + source.w) / texture.textureWidth;
+	command.bottom = static_cast<float>(source.y + source.h) / texture.textureHeight;
+	command.destination = dstRect;
+	command.rotation = rotation;
+	command.color = color;
+
+	push(pass, layer, depth, reinterpret_cast<uintptr_t>(texture.texture), command);
+}
+
+void RenderQueue::submitText(RenderPass pass, int layer, const GlyphAtlas& atlas, const std::string& text, float x, float y, SDL_Color color, uint16_t depth) {
+
+	if (atlas.getTexture() == nullptr) {
+		return;
+	}
+
+	const TextureInfo texture{ atlas.getTexture(), 0, 0, atlas.getWidth(), atlas.getHeight(), atlas.getWidth(), atlas.getHeight() };
+
+	float penX = x;
+	char previous = 0;
+
+	for (char character : text) {
+
+		const Glyph* glyph = atlas.getGlyph(character);
+
+		if (glyph == nullptr) {
+			continue;
+		}
+
+		penX += atlas.getKerning(previous, character);
+		previous = character;
+
+		const SDL_Rect& source = glyph->source;
+
+		if (source.w > 0 && source.h > 0) {
+			const SDL_FRect destination{ penX, y, static_cast<float>(source.w), static_cast<float>(source.h) };
+			submitSprite(pass, layer, texture, source, destination, 0.0f, color, depth);
+		}
+
+		penX += glyph->advance;
+	}
+}
+
+void RenderQueue::submitRect(RenderPass pass, int layer, const SDL_FRect& rect, SDL_Color color, bool isFilled, uint16_t depth) {
+
+	RenderCommand command;
+	command.type = isFilled ? RenderCommandType::fillRect : RenderCommandType::drawRect;
+	command.texture = nullptr;
+	command.left = 0.0f;
+	command.top = 0.0f;
+	command.right = 0.0f;
+	command.bottom = 0.0f;
+	command.destination = rect;
+	command.rotation = 0.0f;
+	command.color = color;
+
+	// Rectangles are untextured geometry, whatever their colour
+	push(pass, layer, depth, 0, command);
+}
+
+void RenderQueue::sort() {
+
+	const int count = static_cast<int>(entries.size());
+
+	sortBuffer.resize(count);
+
+	// Least significant byte first. Every pass is a stable counting sort, so
+	// the order of the lower bytes survives the higher ones
+	for (int shift = 0; shift < 64; shift += 8) {
+
+		int counts[256] = {};
+
+		for (const auto& entry : entries) {
+			counts[(entry.key >> shift) & 0xFF]++;
+		}
+
+		// A byte every key shares would not move anything
+		if (counts[(entries[0].key >> shift) & 0xFF] == count) {
+			continue;
+		}
+
+		int offsets[256];
+		int offset = 0;
+
+		for (int bucket = 0; bucket < 256; bucket++) {
+			offsets[bucket] = offset;
+			offset += counts[bucket];
+		}
+
+		for (const auto& entry : entries) {
+			sortBuffer[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+		}
+
+		entries.swap(sortBuffer);
+	}
+}
+
+void RenderQueue::addQuad(const RenderCommand& command) {
+
+	const int first = static_cast<int>(vertices.size());
+	const SDL_FRect& destination = command.destination;
+
+	if (command.rotation == 0.0f) {
+
+		// Most quads are not turned, their corners are the destination rectangle
+		const float x = destination.x;
+		const float y = destination.y;
+		const float w = destination.w;
+		const float h = destination.h;
+
+		vertices.push_back({ { x, y }, command.color, { command.left, command.top } });
+		vertices.push_back({ { x + w, y }, command.color, { command.right, command.top } });
+		vertices.push_back({ { x + w, y + h }, command.color, { command.right, command.bottom } });
+		vertices.push_back({ { x, y + h }, command.color, { command.left, command.bottom } });
+	}
+	else {
+
+		const float radians = static_cast<float>(command.rotation * M_PI / 180.0);
+		const float cosine = std::cos(radians);
+		const float sine = std::sin(radians);
+
+		const float centerX = destination.x + destination.w * 0.5f;
+		const float centerY = destination.y + destination.h * 0.5f;
+		const float halfW = destination.w * 0.5f;
+		const float halfH = destination.h * 0.5f;
+
+		// With y pointing down a positive angle turns the corners clockwise
+		auto corner = [&](float dx, float dy, float u, float v) {
+			vertices.push_back({
+				{ centerX + dx * cosine - dy * sine, centerY + dx * sine + dy * cosine },
+				command.color,
+				{ u, v } });
+		};
+
+		corner(-halfW, -halfH, command.left, command.top);
+		corner(halfW, -halfH, command.right, command.top);
+		corner(halfW, halfH, command.right, command.bottom);
+		corner(-halfW, halfH, command.left, command.bottom);
+	}
+
+	indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+}
+
+void RenderQueue::addQuad(const SDL_FRect& rect, SDL_Color color) {
+
+	const int first = static_cast<int>(vertices.size());
+
+	vertices.push_back({ { rect.x, rect.y }, color, { 0.0f, 0.0f } });
+	vertices.push_back({ { rect.x + rect.w, rect.y }, color, { 0.0f, 0.0f } });
+	vertices.push_back({ { rect.x + rect.w, rect.y + rect.h }, color, { 0.0f, 0.0f } });
+	vertices.push_back({ { rect.x, rect.y + rect.h }, color, { 0.0f, 0.0f } });
+
+	indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+}
+
+void RenderQueue::addOutline(const SDL_FRect& rect, SDL_Color color) {
+
+	// One pixel wide edges covering the same pixels SDL_RenderDrawRect does
+	if (rect.w <= 2.0f || rect.h <= 2.0f) {
+		addQuad(rect, color);
+		return;
+	}
+
+	addQuad({ rect.x, rect.y, rect.w, 1.0f }, color);
+	addQuad({ rect.x, rect.y + rect.h - 1.0f, rect.w, 1.0f }, color);
+	addQuad({ rect.x, rect.y + 1.0f, 1.0f, rect.h - 2.0f }, color);
+	addQuad({ rect.x + rect.w - 1.0f, rect.y + 1.0f, 1.0f, rect.h - 2.0f }, color);
+}
+
+void RenderQueue::buildRun(int first, int last) {
+
+	vertices.clear();
+	indices.clear();
+
+	for (int i = first; i < last; i++) {
+
+		const RenderCommand& command = commands[entries[i].command];
+
+		switch (command.type) {
+		case RenderCommandType::sprite:
+			addQuad(command);
+			break;
+		case RenderCommandType::fillRect:
+			addQuad(command.destination, command.color);
+			break;
+		case RenderCommandType::drawRect:
+			addOutline(command.destination, command.color);
+			break;
+		}
+	}
+}
+
+void RenderQueue::drawRuns(const std::function<void(SDL_Texture* texture)>& draw) {
+
+	drawCallCount = 0;
+	stateChangeCount = 0;
+
+	if (entries.empty()) {
+		return;
+	}
+
+	sort();
+
+	// Rectangles have no texture, so they only break a run where a sprite starts
+	auto sameState = [](const RenderCommand& a, const RenderCommand& b) {
+		return a.texture == b.texture;
+	};
+
+	const int count = static_cast<int>(entries.size());
+	const RenderCommand* previous = nullptr;
+	int first = 0;
+
+	// Every run of commands with the same texture is one draw call
+	for (int i = 1; i <= count; i++) {
+
+		if (i < count && sameState(commands[entries[i].command], commands[entries[first].command])) {
+			continue;
+		}
+
+		const RenderCommand& head = commands[entries[first].command];
+
+		if (previous == nullptr || !sameState(*previous, head)) {
+			stateChangeCount++;
+		}
+
+		buildRun(first, i);
+		draw(head.texture);
+		drawCallCount++;
+
+		previous = &head;
+		first = i;
+	}
+
+	clear();
+}
+
+void RenderQueue::flush(SDL_Renderer* renderer) {
+
+	// Without a texture the vertex colours are drawn as they are
+	drawRuns([&](SDL_Texture* texture) {
+		if (SDL_RenderGeometry(
+			renderer,
+			texture,
+			vertices.data(),
+			static_cast<int>(vertices.size()),
+			indices.data(),
+			static_cast<int>(indices.size())) != 0) {
+			Logger::LogErr(SDL_GetError());
+		}
+	});
+}
+
+void RenderQueue::flush(SoftwareRasterizer& rasterizer) {
+
+	drawRuns([&](SDL_Texture* texture) {
+		rasterizer.drawGeometry(
+			texture,
+			vertices.data(),
+			static_cast<int>(vertices.size()),
+			indices.data(),
+			static_cast<int>(indices.size()));
+	});
+
+	rasterizer.finish();
+}
+
+void RenderQueue::clear() {
+	commands.clear();
+	entries.clear();
+}
+
+int RenderQueue::getCommandCount() const {
+	return static_cast<int>(commands.size());
+}
+
+int RenderQueue::getDrawCallCount() const {
+	return drawCallCount;
+}
+
+int RenderQueue::getStateChangeCount() const {
+	return stateChangeCount;
+}
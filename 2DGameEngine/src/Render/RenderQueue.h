@@ -0,0 +1,119 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Assets/AssetStore.h"
+#include "../Assets/GlyphAtlas.h"
+#include "SoftwareRasterizer.h"
+
+// Coarse draw order, every command of a pass is drawn before any of the next
+enum class RenderPass : uint8_t {
+	background = 0,
+	sprites,
+	debug,
+	overlays,
+	text,
+	// Screen space images, drawn through the queue only when rendering in software
+	hud
+};
+
+enum class RenderCommandType : uint8_t {
+	sprite,
+	fillRect,
+	drawRect
+};
+
+/// <summary>
+/// One submitted draw, plain data so a frame's worth can be sorted and
+/// replayed. Sprites carry their texture coordinates already normalised,
+/// rectangles have no texture and take their colour from the vertices
+/// </summary>
+struct RenderCommand {
+	RenderCommandType type;
+	SDL_Texture* texture;
+	float left;
+	float top;
+	float right;
+	float bottom;
+	SDL_FRect destination;
+	float rotation;
+	SDL_Color color;
+};
+
+/// <summary>
+/// Collects every draw of a frame under a 64 bit sort key, sorts the keys
+/// with a stable radix sort and replays the commands in key order. Within
+/// a pass, layer and depth the commands are grouped by texture, so every
+/// run of the same texture goes out in one SDL_RenderGeometry call. Filled
+/// and outlined rectangles of any colour share the untextured state, so a
+/// pass of health bars or collider boxes is a single call
+/// </summary>
+class RenderQueue {
+
+private:
+
+	// Key layout from the most significant bit:
+	// pass 3 | layer 5 | depth 16 | state 16 | sequence 24
+	static const int SEQUENCE_BITS = 24;
+	static const int STATE_BITS = 16;
+	static const int DEPTH_BITS = 16;
+	static const int LAYER_BITS = 5;
+
+	struct SortEntry {
+		uint64_t key;
+		uint32_t command;
+	};
+
+	std::vector<RenderCommand> commands;
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> sortBuffer;
+
+	// Small numbers for textures, so they fit the state bits
+	std::unordered_map<uint64_t, uint32_t> stateKeys;
+
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+
+	int drawCallCount = 0;
+	int stateChangeCount = 0;
+
+	uint32_t getStateKey(uint64_t state);
+	void push(RenderPass pass, int layer, uint16_t depth, uint64_t state, const RenderCommand& command);
+
+	void sort();
+	void addQuad(const RenderCommand& command);
+	void addQuad(const SDL_FRect& rect, SDL_Color color);
+	void addOutline(const SDL_FRect& rect, SDL_Color color);
+	void buildRun(int first, int last);
+	// Sorts, builds the geometry of every run and hands it to draw, then empties the queue
+	void drawRuns(const std::function<void(SDL_Texture* texture)>& draw);
+
+public:
+
+	RenderQueue() = default;
+
+	// Draws srcRect of the image into dstRect, turned clockwise by rotation
+	// degrees around the centre of dstRect like SDL_RenderCopyEx does
+	void submitSprite(RenderPass pass, int layer, const TextureInfo& texture, const SDL_Rect& srcRect, const SDL_FRect& dstRect, float rotation, SDL_Color color = { 255, 255, 255, 255 }, uint16_t depth = 0);
+
+	// Lays the text out on one line from its top left corner
+	void submitText(RenderPass pass, int layer, const GlyphAtlas& atlas, const std::string& text, float x, float y, SDL_Color color, uint16_t depth = 0);
+
+	void submitRect(RenderPass pass, int layer, const SDL_FRect& rect, SDL_Color color, bool isFilled, uint16_t depth = 0);
+
+	// Sorts and draws everything submitted since the last flush, then empties the queue
+	void flush(SDL_Renderer* renderer);
+	// The same, rasterised into the software framebuffer
+	void flush(SoftwareRasterizer& rasterizer);
+
+	// Drops everything submitted without drawing it
+	void clear();
+
+	int getCommandCount() const;
+	// Draw calls and texture switches of the last flush
+	int getDrawCallCount() const;
+	int getStateChangeCount() const;
+};
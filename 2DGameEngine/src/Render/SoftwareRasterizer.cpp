@@ -0,0 +1,434 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RASTERIZER_SSE2
+#endif
+
+namespace {
+
+	// Rounded x / 255 for x up to 255 * 255
+	inline uint32_t divide255(uint32_t x) {
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	// Premultiplied source over destination
+	inline uint32_t blend(uint32_t source, uint32_t destination) {
+
+		const uint32_t inverseAlpha = 255 - (source >> 24);
+
+		if (inverseAlpha == 0) {
+			return source;
+		}
+
+		uint32_t result = 0;
+
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint32_t channel = ((source >> shift) & 0xFF) + divide255(((destination >> shift) & 0xFF) * inverseAlpha);
+			result |= std::min(channel, 255u) << shift;
+		}
+
+		return result;
+	}
+
+	inline void blend4(const uint32_t* source, uint32_t* destination) {
+
+#ifdef SOFTWARE_RASTERIZER_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rounding = _mm_set1_epi16(128);
+
+		const __m128i sourcePixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+		const __m128i destinationPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination));
+
+		// 255 - alpha copied into every byte of its pixel
+		__m128i inverseAlpha = _mm_sub_epi32(_mm_set1_epi32(255), _mm_srli_epi32(sourcePixels, 24));
+		inverseAlpha = _mm_or_si128(inverseAlpha, _mm_slli_epi32(inverseAlpha, 8));
+		inverseAlpha = _mm_or_si128(inverseAlpha, _mm_slli_epi32(inverseAlpha, 16));
+
+		// Two pixels per register at 16 bits a channel, so the products fit
+		__m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(destinationPixels, zero), _mm_unpacklo_epi8(inverseAlpha, zero));
+		__m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(destinationPixels, zero), _mm_unpackhi_epi8(inverseAlpha, zero));
+
+		low = _mm_add_epi16(low, rounding);
+		high = _mm_add_epi16(high, rounding);
+		low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+		high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+		const __m128i result = _mm_adds_epu8(sourcePixels, _mm_packus_epi16(low, high));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), result);
+#else
+		for (int i = 0; i < 4; i++) {
+			destination[i] = blend(source[i], destination[i]);
+		}
+#endif
+	}
+
+	// Scales every channel of a premultiplied pixel by the tint, each 0 to 256
+	inline uint32_t modulate(uint32_t pixel, const uint32_t tint[4]) {
+		return (((pixel >> 24) * tint[3] >> 8) << 24) |
+			((((pixel >> 16) & 0xFF) * tint[0] >> 8) << 16) |
+			((((pixel >> 8) & 0xFF) * tint[1] >> 8) << 8) |
+			((pixel & 0xFF) * tint[2] >> 8);
+	}
+
+	inline uint32_t lerpPixel(uint32_t a, uint32_t b, uint32_t weight) {
+
+		uint32_t result = 0;
+
+		for (int shift = 0; shift < 32; shift += 8) {
+			const uint32_t channelA = (a >> shift) & 0xFF;
+			const uint32_t channelB = (b >> shift) & 0xFF;
+			result |= ((channelA * (256 - weight) + channelB * weight) >> 8) << shift;
+		}
+
+		return result;
+	}
+}
+
+SoftwareRasterizer::SoftwareRasterizer(WorkerPool* workerPool) : workerPool(workerPool) {
+}
+
+void SoftwareRasterizer::resize(int width, int height) {
+	this->width = std::max(width, 0);
+	this->height = std::max(height, 0);
+	pixels.assign(static_cast<size_t>(this->width) * this->height, 0);
+}
+
+void SoftwareRasterizer::setSampling(TextureSampling sampling) {
+	this->sampling = sampling;
+}
+
+void SoftwareRasterizer::setImageLookup(const std::function<const SoftwareImage*(SDL_Texture*)>& findImage) {
+	this->findImage = findImage;
+}
+
+void SoftwareRasterizer::clear(SDL_Color color) {
+
+	const uint32_t alpha = color.a;
+	const uint32_t pixel = (alpha << 24) |
+		(divide255(color.r * alpha) << 16) |
+		(divide255(color.g * alpha) << 8) |
+		divide255(color.b * alpha);
+
+	triangles.clear();
+	std::fill(pixels.begin(), pixels.end(), pixel);
+}
+
+void SoftwareRasterizer::drawGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+
+	const SoftwareImage* image = nullptr;
+
+	if (texture != nullptr) {
+
+		image = findImage ? findImage(texture) : nullptr;
+
+		if (image == nullptr || image->getWidth() == 0 || image->getHeight() == 0) {
+			return;
+		}
+	}
+
+	const int count = indices != nullptr ? indexCount : vertexCount;
+
+	for (int i = 0; i + 2 < count; i += 3) {
+
+		const int a = indices != nullptr ? indices[i] : i;
+		const int b = indices != nullptr ? indices[i + 1] : i + 1;
+		const int c = indices != nullptr ? indices[i + 2] : i + 2;
+
+		if (a < 0 || b < 0 || c < 0 || a >= vertexCount || b >= vertexCount || c >= vertexCount) {
+			continue;
+		}
+
+		addTriangle(vertices[a], vertices[b], vertices[c], image);
+	}
+}
+
+void SoftwareRasterizer::addTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c, const SoftwareImage* image) {
+
+	const SDL_Vertex* corners[3] = { &a, &b, &c };
+
+	Triangle triangle;
+	triangle.image = image;
+
+	// Edge i runs between the other two corners, and is scaled so it is 1 at corner i
+	float scales[3];
+
+	for (int i = 0; i < 3; i++) {
+
+		const SDL_FPoint& from = corners[(i + 1) % 3]->position;
+		const SDL_FPoint& to = corners[(i + 2) % 3]->position;
+		const SDL_FPoint& opposite = corners[i]->position;
+
+		float edgeA = from.y - to.y;
+		float edgeB = to.x - from.x;
+		float edgeC = -(edgeA * from.x + edgeB * from.y);
+		const float atOpposite = edgeA * opposite.x + edgeB * opposite.y + edgeC;
+
+		if (atOpposite == 0.0f) {
+			return;
+		}
+
+		if (atOpposite < 0.0f) {
+			edgeA = -edgeA;
+			edgeB = -edgeB;
+			edgeC = -edgeC;
+		}
+
+		triangle.edgeA[i] = edgeA;
+		triangle.edgeB[i] = edgeB;
+		triangle.edgeC[i] = edgeC;
+		// A neighbour sees the shared edge negated, so exactly one of the two owns it
+		triangle.isInclusive[i] = edgeA > 0.0f || (edgeA == 0.0f && edgeB > 0.0f);
+		scales[i] = 1.0f / std::fabs(atOpposite);
+	}
+
+	// An attribute is the sum of its corner values weighted by the scaled edges
+	auto plane = [&](float values[3]) {
+		Plane result{ 0.0f, 0.0f, 0.0f };
+		for (int i = 0; i < 3; i++) {
+			result.dx += values[i] * triangle.edgeA[i] * scales[i];
+			result.dy += values[i] * triangle.edgeB[i] * scales[i];
+			result.base += values[i] * triangle.edgeC[i] * scales[i];
+		}
+		return result;
+	};
+
+	float u[3] = { a.tex_coord.x, b.tex_coord.x, c.tex_coord.x };
+	float v[3] = { a.tex_coord.y, b.tex_coord.y, c.tex_coord.y };
+	float red[3];
+	float green[3];
+	float blue[3];
+	float alpha[3];
+
+	for (int i = 0; i < 3; i++) {
+		red[i] = corners[i]->color.r;
+		green[i] = corners[i]->color.g;
+		blue[i] = corners[i]->color.b;
+		alpha[i] = corners[i]->color.a;
+	}
+
+	triangle.u = plane(u);
+	triangle.v = plane(v);
+	triangle.colour[0] = plane(red);
+	triangle.colour[1] = plane(green);
+	triangle.colour[2] = plane(blue);
+	triangle.colour[3] = plane(alpha);
+
+	auto sameColour = [](const SDL_Color& first, const SDL_Color& second) {
+		return first.r == second.r && first.g == second.g && first.b == second.b && first.a == second.a;
+	};
+
+	triangle.isFlatColour = sameColour(a.color, b.color) && sameColour(a.color, c.color);
+
+	// A flat colour is kept exact instead of going through the planes
+	if (triangle.isFlatColour) {
+		triangle.colour[0] = Plane{ 0.0f, 0.0f, static_cast<float>(a.color.r) };
+		triangle.colour[1] = Plane{ 0.0f, 0.0f, static_cast<float>(a.color.g) };
+		triangle.colour[2] = Plane{ 0.0f, 0.0f, static_cast<float>(a.color.b) };
+		triangle.colour[3] = Plane{ 0.0f, 0.0f, static_cast<float>(a.color.a) };
+	}
+
+	const float minX = std::min({ a.position.x, b.position.x, c.position.x });
+	const float maxX = std::max({ a.position.x, b.position.x, c.position.x });
+	const float minY = std::min({ a.position.y, b.position.y, c.position.y });
+	const float maxY = std::max({ a.position.y, b.position.y, c.position.y });
+
+	triangle.minX = std::max(0, static_cast<int>(std::floor(minX)));
+	triangle.maxX = std::min(width - 1, static_cast<int>(std::ceil(maxX)));
+	triangle.minY = std::max(0, static_cast<int>(std::floor(minY)));
+	triangle.maxY = std::min(height - 1, static_cast<int>(std::ceil(maxY)));
+
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+		return;
+	}
+
+	triangles.push_back(triangle);
+}
+
+uint32_t SoftwareRasterizer::sample(const SoftwareImage& image, float u, float v) const {
+
+	const int imageWidth = image.getWidth();
+	const int imageHeight = image.getHeight();
+	const uint32_t* imagePixels = image.getPixels();
+
+	if (sampling == TextureSampling::nearest) {
+		const int x = std::clamp(static_cast<int>(u * imageWidth), 0, imageWidth - 1);
+		const int y = std::clamp(static_cast<int>(v * imageHeight), 0, imageHeight - 1);
+		return imagePixels[static_cast<size_t>(y) * imageWidth + x];
+	}
+
+	// Texel centres are at half pixels, so step back half a texel before weighing the four around
+	const float x = u * imageWidth - 0.5f;
+	const float y = v * imageHeight - 0.5f;
+	const float floorX = std::floor(x);
+	const float floorY = std::floor(y);
+	const uint32_t weightX = static_cast<uint32_t>((x - floorX) * 256.0f);
+	const uint32_t weightY = static_cast<uint32_t>((y - floorY) * 256.0f);
+
+	const int left = std::clamp(static_cast<int>(floorX), 0, imageWidth - 1);
+	const int right = std::clamp(static_cast<int>(floorX) + 1, 0, imageWidth - 1);
+	const int top = std::clamp(static_cast<int>(floorY), 0, imageHeight - 1);
+	const int bottom = std::clamp(static_cast<int>(floorY) + 1, 0, imageHeight - 1);
+
+	const uint32_t* topRow = imagePixels + static_cast<size_t>(top) * imageWidth;
+	const uint32_t* bottomRow = imagePixels + static_cast<size_t>(bottom) * imageWidth;
+
+	return lerpPixel(
+		lerpPixel(topRow[left], topRow[right], weightX),
+		lerpPixel(bottomRow[left], bottomRow[right], weightX),
+		weightY);
+}
+
+void SoftwareRasterizer::drawSpan(const Triangle& triangle, int y, int firstX, int lastX) {
+
+	uint32_t* row = pixels.data() + static_cast<size_t>(y) * width;
+
+	const float centreY = static_cast<float>(y) + 0.5f;
+	const float startX = static_cast<float>(firstX) + 0.5f;
+
+	float u = triangle.u.at(startX, centreY);
+	float v = triangle.v.at(startX, centreY);
+	float colour[4];
+
+	for (int channel = 0; channel < 4; channel++) {
+		colour[channel] = triangle.colour[channel].at(startX, centreY);
+	}
+
+	// Premultiplied tint, every channel 0 to 256 so 255 leaves a texel as it is
+	uint32_t tint[4];
+
+	auto updateTint = [&]() {
+		const uint32_t alpha = static_cast<uint32_t>(std::clamp(colour[3], 0.0f, 255.0f) + 0.5f);
+		tint[3] = alpha + (alpha >> 7);
+		for (int channel = 0; channel < 3; channel++) {
+			const uint32_t premultiplied = divide255(static_cast<uint32_t>(std::clamp(colour[channel], 0.0f, 255.0f) + 0.5f) * alpha);
+			tint[channel] = premultiplied + (premultiplied >> 7);
+		}
+	};
+
+	updateTint();
+
+	const bool isUntinted = triangle.isFlatColour && tint[0] == 256 && tint[1] == 256 && tint[2] == 256 && tint[3] == 256;
+
+	uint32_t source[4];
+
+	for (int x = firstX; x <= lastX; ) {
+
+		const int count = std::min(4, lastX - x + 1);
+
+		for (int i = 0; i < count; i++) {
+
+			if (!triangle.isFlatColour) {
+				updateTint();
+			}
+
+			const uint32_t texel = triangle.image != nullptr ? sample(*triangle.image, u, v) : 0xFFFFFFFF;
+			source[i] = isUntinted ? texel : modulate(texel, tint);
+
+			u += triangle.u.dx;
+			v += triangle.v.dx;
+
+			if (!triangle.isFlatColour) {
+				for (int channel = 0; channel < 4; channel++) {
+					colour[channel] += triangle.colour[channel].dx;
+				}
+			}
+		}
+
+		if (count == 4) {
+			blend4(source, row + x);
+		}
+		else {
+			for (int i = 0; i < count; i++) {
+				row[x + i] = blend(source[i], row[x + i]);
+			}
+		}
+
+		x += count;
+	}
+}
+
+void SoftwareRasterizer::rasterizeRows(int firstRow, int lastRow) {
+
+	for (const auto& triangle : triangles) {
+
+		const int top = std::max(firstRow, triangle.minY);
+		const int bottom = std::min(lastRow - 1, triangle.maxY);
+
+		for (int y = top; y <= bottom; y++) {
+
+			const float centreY = static_cast<float>(y) + 0.5f;
+			int firstX = triangle.minX;
+			int lastX = triangle.maxX;
+
+			// Each edge bounds the span on one side where a pixel centre crosses it
+			for (int edge = 0; edge < 3 && firstX <= lastX; edge++) {
+
+				const float a = triangle.edgeA[edge];
+				const float rowC = triangle.edgeB[edge] * centreY + triangle.edgeC[edge];
+				const bool isInclusive = triangle.isInclusive[edge];
+
+				if (a == 0.0f) {
+					if (rowC < 0.0f || (rowC == 0.0f && !isInclusive)) {
+						lastX = firstX - 1;
+					}
+					continue;
+				}
+
+				// The pixel centre x + 0.5 where the edge is zero
+				const float crossing = -rowC / a - 0.5f;
+
+				if (a > 0.0f) {
+					const int bound = isInclusive ? static_cast<int>(std::ceil(crossing)) : static_cast<int>(std::floor(crossing)) + 1;
+					firstX = std::max(firstX, bound);
+				}
+				else {
+					const int bound = isInclusive ? static_cast<int>(std::floor(crossing)) : static_cast<int>(std::ceil(crossing)) - 1;
+					lastX = std::min(lastX, bound);
+				}
+			}
+
+			if (firstX <= lastX) {
+				drawSpan(triangle, y, firstX, lastX);
+			}
+		}
+	}
+}
+
+void SoftwareRasterizer::finish() {
+
+	if (triangles.empty() || height == 0) {
+		return;
+	}
+
+	if (workerPool == nullptr || workerPool->getThreadCount() <= 1) {
+		rasterizeRows(0, height);
+	}
+	else {
+
+		// More bands than threads, so a band full of big sprites does not hold everyone up
+		const int bandCount = std::min(height, workerPool->getThreadCount() * 4);
+
+		workerPool->run(bandCount, [this, bandCount](int band) {
+			rasterizeRows(band * height / bandCount, (band + 1) * height / bandCount);
+		});
+	}
+
+	triangles.clear();
+}
+
+int SoftwareRasterizer::getWidth() const {
+	return width;
+}
+
+int SoftwareRasterizer::getHeight() const {
+	return height;
+}
+
+const uint32_t* SoftwareRasterizer::getPixels() const {
+	return pixels.data();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../Assets/SoftwareImage.h"
+#include "../Threading/WorkerPool.h"
+
+enum class TextureSampling {
+	nearest,
+	bilinear
+};
+
+/// <summary>
+/// Draws the same triangles SDL_RenderGeometry takes into a framebuffer in
+/// memory, for machines where SDL would fall back to its slow generic
+/// renderer. Triangles are collected until finish, then the rows of the
+/// framebuffer are split into bands rasterised in parallel, every band
+/// drawing the triangles in submission order. Spans are blended four
+/// pixels at a time with SSE2 where it is available. Pixels are
+/// premultiplied 0xAARRGGBB like SoftwareImage
+/// </summary>
+class SoftwareRasterizer {
+
+private:
+
+	// value = dx * x + dy * y + base, for an attribute across a triangle
+	struct Plane {
+		float dx;
+		float dy;
+		float base;
+
+		float at(float x, float y) const {
+			return dx * x + dy * y + base;
+		}
+	};
+
+	struct Triangle {
+		// nullptr draws the vertex colours as they are
+		const SoftwareImage* image;
+		// Edge functions a * x + b * y + c, positive inside
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		// Which edges own the pixels exactly on them, so triangles sharing an edge never both draw it
+		bool isInclusive[3];
+		Plane u;
+		Plane v;
+		Plane colour[4];
+		bool isFlatColour;
+		int minX;
+		int maxX;
+		int minY;
+		int maxY;
+	};
+
+	int width = 0;
+	int height = 0;
+	std::vector<uint32_t> pixels;
+	std::vector<Triangle> triangles;
+
+	WorkerPool* workerPool;
+	TextureSampling sampling = TextureSampling::nearest;
+	std::function<const SoftwareImage*(SDL_Texture*)> findImage;
+
+	void addTriangle(const SDL_Vertex& a, const SDL_Vertex& b, const SDL_Vertex& c, const SoftwareImage* image);
+	void rasterizeRows(int firstRow, int lastRow);
+	void drawSpan(const Triangle& triangle, int y, int firstX, int lastX);
+	uint32_t sample(const SoftwareImage& image, float u, float v) const;
+
+public:
+
+	// Without a worker pool every row is drawn on the calling thread
+	explicit SoftwareRasterizer(WorkerPool* workerPool = nullptr);
+
+	void resize(int width, int height);
+	void setSampling(TextureSampling sampling);
+	// How a texture handed to drawGeometry is turned into the image to sample
+	void setImageLookup(const std::function<const SoftwareImage*(SDL_Texture*)>& findImage);
+
+	void clear(SDL_Color color);
+
+	// Takes the arguments of SDL_RenderGeometry. A texture without an image is skipped
+	void drawGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount);
+
+	// Rasterises every triangle drawn since the last finish
+	void finish();
+
+	int getWidth() const;
+	int getHeight() const;
+	const uint32_t* getPixels() const;
+};
@@ -0,0 +1,87 @@
+#include "TextBatcher.h"
+#include "../Logger/Logger.h"
+
+TextBatcher::Batch& TextBatcher::getBatch(SDL_Texture* texture) {
+
+	for (auto& batch : batches) {
+		if (batch.texture == texture) {
+			return batch;
+		}
+	}
+
+	batches.push_back({ texture, {}, {} });
+
+	return batches.back();
+}
+
+void TextBatcher::addText(const GlyphAtlas& atlas, const std::string& text, float x, float y, SDL_Color color) {
+
+	if (atlas.getTexture() == nullptr) {
+		return;
+	}
+
+	Batch& batch = getBatch(atlas.getTexture());
+
+	const float inverseWidth = 1.0f / atlas.getWidth();
+	const float inverseHeight = 1.0f / atlas.getHeight();
+
+	float penX = x;
+	char previous = 0;
+
+	for (char character : text) {
+
+		const Glyph* glyph = atlas.getGlyph(character);
+
+		if (glyph == nullptr) {
+			continue;
+		}
+
+		penX += atlas.getKerning(previous, character);
+		previous = character;
+
+		const SDL_Rect& source = glyph->source;
+
+		if (source.w > 0 && source.h > 0) {
+
+			const float left = source.x * inverseWidth;
+			const float top = source.y * inverseHeight;
+			const float right = (source.x + source.w) * inverseWidth;
+			const float bottom = (source.y + source.h) * inverseHeight;
+
+			const int first = static_cast<int>(batch.vertices.size());
+
+			batch.vertices.push_back({ { penX, y }, color, { left, top } });
+			batch.vertices.push_back({ { penX + source.w, y }, color, { right, top } });
+			batch.vertices.push_back({ { penX + source.w, y + source.h }, color, { right, bottom } });
+			batch.vertices.push_back({ { penX, y + source.h }, color, { left, bottom } });
+
+			batch.indices.insert(batch.indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+		}
+
+		penX += glyph->advance;
+	}
+}
+
+void TextBatcher::flush(SDL_Renderer* renderer) {
+
+	for (auto& batch : batches) {
+
+		if (batch.indices.empty()) {
+			continue;
+		}
+
+		if (SDL_RenderGeometry(
+			renderer,
+			batch.texture,
+			batch.vertices.data(),
+			static_cast<int>(batch.vertices.size()),
+			batch.indices.data(),
+			static_cast<int>(batch.indices.size())) != 0) {
+			Logger::LogErr(SDL_GetError());
+		}
+
+		// Keep the memory for the next frame
+		batch.vertices.clear();
+		batch.indices.clear();
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "../Assets/GlyphAtlas.h"
+
+/// <summary>
+/// Collects text as quads cut from glyph atlases, and draws everything
+/// written with one atlas in a single SDL_RenderGeometry call
+/// </summary>
+class TextBatcher {
+
+private:
+
+	struct Batch {
+		SDL_Texture* texture;
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+	};
+
+	// One batch per atlas, there are only ever a couple of fonts
+	std::vector<Batch> batches;
+
+	Batch& getBatch(SDL_Texture* texture);
+
+public:
+
+	TextBatcher() = default;
+
+	// Lays the text out on one line from its top left corner
+	void addText(const GlyphAtlas& atlas, const std::string& text, float x, float y, SDL_Color color);
+
+	// Draws and empties every batch
+	void flush(SDL_Renderer* renderer);
+};
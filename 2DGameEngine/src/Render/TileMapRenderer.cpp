@@ -0,0 +1,191 @@
+#include "TileMapRenderer.h"
+#include "../ECS/ESC.h"
+#include <algorithm>
+#include <cmath>
+
+void TileMapRenderer::forEachTile(const TextureInfo& tileset, const TileMap& tileMap, int chunkColumn, int chunkRow, glm::vec2 origin, const std::function<void(const SDL_Rect& srcRect, const SDL_FRect& dstRect)>& visit) {
+
+	const int tileSize = tileMap.getTileSize();
+	const int chunkSize = tileMap.getChunkSize();
+	const int tilesetColumns = tileset.width / tileSize;
+	const int16_t* tiles = tileMap.getChunk(chunkColumn, chunkRow);
+
+	if (tilesetColumns <= 0) {
+		return;
+	}
+
+	for (int row = 0; row < chunkSize; row++) {
+		for (int column = 0; column < chunkSize; column++) {
+
+			const int tile = tiles[row * chunkSize + column];
+
+			if (tile == TileMap::EMPTY_TILE) {
+				continue;
+			}
+
+			const SDL_Rect srcRect{
+				(tile % tilesetColumns) * tileSize,
+				(tile / tilesetColumns) * tileSize,
+				tileSize,
+				tileSize
+			};
+
+			const SDL_FRect dstRect{
+				origin.x + static_cast<float>(column * tileSize),
+				origin.y + static_cast<float>(row * tileSize),
+				static_cast<float>(tileSize),
+				static_cast<float>(tileSize)
+			};
+
+			visit(srcRect, dstRect);
+		}
+	}
+}
+
+void TileMapRenderer::forEachVisibleChunk(const TileMapView& view, const SDL_Rect& screen, const std::function<void(int chunkColumn, int chunkRow, glm::vec2 origin)>& visit) {
+
+	const TileMap& tileMap = *view.tileMap;
+	const int chunkPixels = tileMap.getChunkSize() * tileMap.getTileSize();
+	const float mapWidth = static_cast<float>(tileMap.getPixelWidth());
+
+	// The screen in map pixels
+	const float left = static_cast<float>(screen.x) - view.position.x;
+	const float top = static_cast<float>(screen.y) - view.position.y;
+	const float right = left + static_cast<float>(screen.w);
+	const float bottom = top + static_cast<float>(screen.h);
+
+	const int firstRow = std::max(0, static_cast<int>(std::floor(top / chunkPixels)));
+	const int lastRow = std::min(tileMap.getChunkRows() - 1, static_cast<int>(std::floor(bottom / chunkPixels)));
+
+	// Which copies of a repeating map are on screen
+	const int firstCopy = view.isRepeating ? static_cast<int>(std::floor(left / mapWidth)) : 0;
+	const int lastCopy = view.isRepeating ? static_cast<int>(std::floor(right / mapWidth)) : 0;
+
+	for (int copy = firstCopy; copy <= lastCopy; copy++) {
+
+		const float copyLeft = left - static_cast<float>(copy) * mapWidth;
+		const float copyRight = right - static_cast<float>(copy) * mapWidth;
+		const int firstColumn = std::max(0, static_cast<int>(std::floor(copyLeft / chunkPixels)));
+		const int lastColumn = std::min(tileMap.getChunkColumns() - 1, static_cast<int>(std::floor(copyRight / chunkPixels)));
+
+		for (int chunkRow = firstRow; chunkRow <= lastRow; chunkRow++) {
+			for (int chunkColumn = firstColumn; chunkColumn <= lastColumn; chunkColumn++) {
+				visit(chunkColumn, chunkRow, glm::vec2(
+					view.position.x + static_cast<float>(copy) * mapWidth + static_cast<float>(chunkColumn * chunkPixels),
+					view.position.y + static_cast<float>(chunkRow * chunkPixels)));
+			}
+		}
+	}
+}
+
+void TileMapRenderer::drawTiles(SDL_Renderer* renderer, const TextureInfo& tileset, const TileMap& tileMap, int chunkColumn, int chunkRow, glm::vec2 origin) const {
+	forEachTile(tileset, tileMap, chunkColumn, chunkRow, origin, [&](const SDL_Rect& srcRect, const SDL_FRect& dstRect) {
+		const SDL_Rect source = tileset.getSource(srcRect);
+		SDL_RenderCopyF(renderer, tileset.texture, &source, &dstRect);
+	});
+}
+
+void TileMapRenderer::drawView(const AssetStore& assetStore, SDL_Renderer* renderer, const TileMapView& view, const SDL_Rect& screen, bool isCached) {
+
+	const TileMap& tileMap = *view.tileMap;
+	const TextureInfo* tileset = assetStore.getTextureInfo(tileMap.getTilesetAssetID());
+
+	if (tileset == nullptr || tileMap.getPixelWidth() == 0 || tileMap.getPixelHeight() == 0) {
+		return;
+	}
+
+	const int chunkPixels = tileMap.getChunkSize() * tileMap.getTileSize();
+
+	auto& layers = chunkLayers[view.tileMap];
+	layers.resize(static_cast<size_t>(tileMap.getChunkColumns()) * tileMap.getChunkRows());
+
+	forEachVisibleChunk(view, screen, [&](int chunkColumn, int chunkRow, glm::vec2 origin) {
+
+		if (!isCached) {
+			drawTiles(renderer, *tileset, tileMap, chunkColumn, chunkRow, origin);
+			return;
+		}
+
+		auto& layer = layers[static_cast<size_t>(chunkRow) * tileMap.getChunkColumns() + chunkColumn];
+
+		if (layer.begin(renderer, SDL_Rect{ 0, 0, chunkPixels, chunkPixels })) {
+			drawTiles(renderer, *tileset, tileMap, chunkColumn, chunkRow, glm::vec2(0, 0));
+			layer.end(renderer);
+		}
+
+		layer.draw(renderer, SDL_FRect{ origin.x, origin.y, static_cast<float>(chunkPixels), static_cast<float>(chunkPixels) });
+	});
+}
+
+void TileMapRenderer::draw(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<TileMapView>& views, const SDL_Rect& screen) {
+
+	const bool isCached = SDL_RenderTargetSupported(renderer);
+
+	for (const auto& view : views) {
+		if (view.tileMap) {
+			drawView(assetStore, renderer, view, screen, isCached);
+		}
+	}
+
+	// Maps that left the level free their chunks
+	for (auto layers = chunkLayers.begin(); layers != chunkLayers.end(); ) {
+
+		const bool isShown = std::any_of(views.begin(), views.end(), [&](const TileMapView& view) {
+			return view.tileMap == layers->first;
+		});
+
+		if (isShown) {
+			++layers;
+			continue;
+		}
+
+		for (auto& layer : layers->second) {
+			layer.destroy();
+		}
+
+		layers = chunkLayers.erase(layers);
+	}
+}
+
+void TileMapRenderer::submit(RenderQueue& renderQueue, const AssetStore& assetStore, const std::vector<TileMapView>& views, const SDL_Rect& screen) const {
+
+	for (size_t i = 0; i < views.size(); i++) {
+
+		const TileMapView& view = views[i];
+
+		if (!view.tileMap || view.tileMap->getPixelWidth() == 0 || view.tileMap->getPixelHeight() == 0) {
+			continue;
+		}
+
+		const TextureInfo* tileset = assetStore.getTextureInfo(view.tileMap->getTilesetAssetID());
+
+		if (tileset == nullptr) {
+			continue;
+		}
+
+		// The depth keeps the views in the order they were given
+		const uint16_t depth = static_cast<uint16_t>(i);
+
+		forEachVisibleChunk(view, screen, [&](int chunkColumn, int chunkRow, glm::vec2 origin) {
+			forEachTile(*tileset, *view.tileMap, chunkColumn, chunkRow, origin, [&](const SDL_Rect& srcRect, const SDL_FRect& dstRect) {
+				renderQueue.submitSprite(RenderPass::background, Layer::tileMap, *tileset, srcRect, dstRect, 0.0f, SDL_Color{ 255, 255, 255, 255 }, depth);
+			});
+		});
+	}
+}
+
+void TileMapRenderer::invalidate() {
+	for (auto& layers : chunkLayers) {
+		for (auto& layer : layers.second) {
+			layer.invalidate();
+		}
+	}
+}
+
+void TileMapRenderer::resetLayers() {
+	for (auto& layers : chunkLayers) {
+		for (auto& layer : layers.second) {
+			layer.destroy();
+		}
+	}
+}
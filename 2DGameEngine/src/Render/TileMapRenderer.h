@@ -0,0 +1,59 @@
+#pragma once
+#include <SDL.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "../Assets/AssetStore.h"
+#include "../TileMap/TileMap.h"
+#include "CachedLayer.h"
+#include "RenderQueue.h"
+
+/// <summary>
+/// One tile map layer as a frame shows it. Position is where the top left
+/// of the map is on screen, and a repeating map is tiled left and right
+/// </summary>
+struct TileMapView {
+	std::shared_ptr<const TileMap> tileMap;
+	glm::vec2 position;
+	bool isRepeating;
+};
+
+/// <summary>
+/// Draws tile maps from a render target per chunk. A chunk is drawn tile by
+/// tile the first time it shows and copied whole after that, so a frame
+/// costs one copy per visible chunk however big the map is. Lives with
+/// the renderer
+/// </summary>
+class TileMapRenderer {
+
+private:
+
+	// Chunks of the maps drawn last frame, in the map's chunk order
+	std::map<std::shared_ptr<const TileMap>, std::vector<CachedLayer>> chunkLayers;
+
+	// srcRect is relative to the tileset image
+	static void forEachTile(const TextureInfo& tileset, const TileMap& tileMap, int chunkColumn, int chunkRow, glm::vec2 origin, const std::function<void(const SDL_Rect& srcRect, const SDL_FRect& dstRect)>& visit);
+	// origin is where the chunk's top left is on screen, once per copy of a repeating map
+	static void forEachVisibleChunk(const TileMapView& view, const SDL_Rect& screen, const std::function<void(int chunkColumn, int chunkRow, glm::vec2 origin)>& visit);
+
+	void drawTiles(SDL_Renderer* renderer, const TextureInfo& tileset, const TileMap& tileMap, int chunkColumn, int chunkRow, glm::vec2 origin) const;
+	void drawView(const AssetStore& assetStore, SDL_Renderer* renderer, const TileMapView& view, const SDL_Rect& screen, bool isCached);
+
+public:
+
+	TileMapRenderer() = default;
+
+	// Draws the views in order, screen is the part of the target that shows
+	void draw(const AssetStore& assetStore, SDL_Renderer* renderer, const std::vector<TileMapView>& views, const SDL_Rect& screen);
+
+	// Queues the visible tiles as sprites instead, for the software rasterizer which has no render targets
+	void submit(RenderQueue& renderQueue, const AssetStore& assetStore, const std::vector<TileMapView>& views, const SDL_Rect& screen) const;
+
+	// The renderer lost what was drawn into its targets
+	void invalidate();
+
+	// The renderer lost its textures altogether
+	void resetLayers();
+};
@@ -1,13 +1,23 @@
 #pragma once
 #include "../Components/Components.h"
+#include "SpatialIndexSystem.h"
+#include "../Math/Trig.h"
 #include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
 
 class AISystem : public System {
 
 private:
 
+	// Kept between updates so steering does not allocate every tick
+	std::vector<Entity> steeringEntities;
+	std::vector<float> directionsX;
+	std::vector<float> directionsY;
+	std::vector<float> angles;
+
 	void launchProjectile(std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry, std::unique_ptr<AssetStore>& assetStore, ProjectileEmitterComponent& projectileComponent) {
-		if (static_cast<int>(SDL_GetTicks()) - projectileComponent.lastEmissionTime > projectileComponent.repeatFrequency) {
+		if (static_cast<int>(SimulationClock::getTicks()) - projectileComponent.lastEmissionTime > projectileComponent.repeatFrequency) {
 			eventBus->publishEvent<ProjectileEvent>(registry, SDLK_UNKNOWN);
 			eventBus->publishEvent<SoundEffectEvent>(assetStore, "enemyLaser");
 		}
@@ -25,44 +35,69 @@ public:
 
 	void update(std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry, std::unique_ptr<AssetStore>& assetStore, int mapWidth) {
 
+		auto& spatialIndexSystem = registry->getSystem<SpatialIndexSystem>();
+
+		steeringEntities.clear();
+		directionsX.clear();
+		directionsY.clear();
+
+		// First every AI finds its target, then the angles are worked out in one pass over the directions
 		for (auto& entity : getEntities()) {
 
 			const auto& trackingComponent = entity.getComponent<TrackingComponent>();
 			const auto& spriteSize = entity.getComponent<SpriteComponent>().size;
-			auto& projectileEmitterComponent = entity.getComponent<ProjectileEmitterComponent>();
-			auto& rigidBodyComponent = entity.getComponent<RigidBodyComponent>();
-			auto& transformComponent = entity.getComponent<TransformComponent>();
+			const auto& transformComponent = entity.getComponent<TransformComponent>();
+
+			glm::vec2 entityCenterPoint = transformComponent.position + (spriteSize * 0.5f);
 
-			if (trackingComponent.entity) {
-				const Entity& playerEntity = *trackingComponent.entity;
+			// Go after the nearest player ship, the tracked entity is the fallback
+			std::vector<Entity> targets = spatialIndexSystem.nearestK(entityCenterPoint, 1, layerBit(player));
+			const Entity* targetEntity = !targets.empty() ? &targets[0] : trackingComponent.entity;
+
+			if (targetEntity) {
+				const Entity& playerEntity = *targetEntity;
 				const auto& playerEntityTransformComponent = playerEntity.getComponent<TransformComponent>();
 				const auto& playerSize = playerEntity.getComponent<SpriteComponent>().size;
 				
 				glm::vec2 playerCenterPoint = playerEntityTransformComponent.position + (playerSize * 0.5f);
-				glm::vec2 entityCenterPoint = transformComponent.position + (spriteSize * 0.5f);
-
 				glm::vec2 directionVector = playerCenterPoint - entityCenterPoint;
-				glm::vec2 normalisedDirectionVector = glm::normalize(directionVector);
 
-				double radians = glm::atan(normalisedDirectionVector.y, normalisedDirectionVector.x);
-				double degrees = glm::degrees(radians);
+				steeringEntities.push_back(entity);
+				directionsX.push_back(directionVector.x);
+				directionsY.push_back(directionVector.y);
+			}
+			else {
+				Logger::Log("entityToTrack is a nullptr");
+			}
+		}
+
+		const int count = static_cast<int>(steeringEntities.size());
 
-				double entityFacingDirection = glm::degrees(std::acos(-1));
+		angles.resize(count);
+		Trig::fastAnglesOf(directionsX.data(), directionsY.data(), angles.data(), count);
 
-				double finalRotation = degrees + entityFacingDirection;
-				
-				rigidBodyComponent.veclocity = normalisedDirectionVector * rigidBodyComponent.speed;
-				transformComponent.rotation = finalRotation;
+		for (int i = 0; i < count; i++) {
+
+			const Entity& entity = steeringEntities[i];
+			auto& projectileEmitterComponent = entity.getComponent<ProjectileEmitterComponent>();
+			auto& rigidBodyComponent = entity.getComponent<RigidBodyComponent>();
+			auto& transformComponent = entity.getComponent<TransformComponent>();
 
-				if (transformComponent.position.x < mapWidth) {
-					launchProjectile(eventBus, registry, assetStore, projectileEmitterComponent);
-				}
+			const float lengthSquared = directionsX[i] * directionsX[i] + directionsY[i] * directionsY[i];
 
+			// Sitting on the target there is no way to go, the AI keeps its heading
+			if (lengthSquared > 0.0f) {
+
+				const float scale = rigidBodyComponent.speed / std::sqrt(lengthSquared);
+
+				rigidBodyComponent.veclocity = glm::vec2(directionsX[i] * scale, directionsY[i] * scale);
+				// The enemy sprites face the other way, so they turn half a turn past the direction
+				transformComponent.rotation = angles[i] + 180.0f;
 			}
-			else {
-				Logger::Log("entityToTrack is a nullptr");
+
+			if (transformComponent.position.x < mapWidth) {
+				launchProjectile(eventBus, registry, assetStore, projectileEmitterComponent);
 			}
 		}
 	}
 };
-
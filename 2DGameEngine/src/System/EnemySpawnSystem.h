@@ -38,7 +38,7 @@ private:
 			enemyShip.addComponent<RigidBodyComponent>(-glm::vec2(event.speed, 0.0f));
 			enemyShip.addComponent<SpriteComponent>(enemySpriteName, glm::vec2(spriteSize.w, spriteSize.h), glm::vec2(spriteSize.x, spriteSize.y), false);
 			enemyShip.addComponent<EnemyComponent>();
-			enemyShip.addComponent<BoxColliderComponent>(spriteSize.w, spriteSize.h);
+			enemyShip.addComponent<BoxColliderComponent>(spriteSize.w, spriteSize.h, glm::vec2(0, 0), CATEGORY_ENEMY);
 			enemyShip.addComponent<HealthComponent>();
 			enemyShip.addComponent<ExplosionComponent>();
 			enemyShip.addComponent<ExtraDamageTakenComponent>(0.5f);
@@ -70,7 +70,7 @@ private:
 			enemyAI.addComponent<SpriteComponent>(assetID, glm::vec2(spriteSize.w, spriteSize.h), glm::vec2(spriteSize.x, spriteSize.y), false);
 			enemyAI.addComponent<EnemyComponent>();
 			enemyAI.addComponent<TrackingComponent>(playerEntity);
-			enemyAI.addComponent<BoxColliderComponent>(spriteSize.w, spriteSize.h);
+			enemyAI.addComponent<BoxColliderComponent>(spriteSize.w, spriteSize.h, glm::vec2(0, 0), CATEGORY_ENEMY);
 			enemyAI.addComponent<HealthComponent>();
 			enemyAI.addComponent<ExplosionComponent>();
 			enemyAI.addComponent<TextLabelComponent>("digiBody", glm::vec2(0, 0), "100%", Color::GREEN);
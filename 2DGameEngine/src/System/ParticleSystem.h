@@ -0,0 +1,256 @@
+#pragma once
+#include "../ECS/ESC.h"
+#include "../Components/Components.h"
+#include "../Events/Events.h"
+#include "../Events/EventBus.h"
+#include "../Assets/AssetStore.h"
+#include "../Render/RenderQueue.h"
+#include "../Particles/ParticlePool.h"
+#include "../Math/Affine2D.h"
+#include "../Logger/Logger.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// How a particle looks. The image is a strip of frameCount frames played
+/// once over the particle's life, drawn at size and shrunk or grown
+/// towards endScale
+/// </summary>
+struct ParticleStyle {
+	std::string assetid;
+	int frameWidth = 0;
+	int frameHeight = 0;
+	int frameCount = 1;
+	glm::vec2 size = glm::vec2(0, 0);
+	float endScale = 1.0f;
+	bool fadeOut = true;
+	// Turns the image to face the way the particle is moving, for streaks like sparks
+	bool alignToVelocity = false;
+	int textureID = -1;
+};
+
+class ParticleSystem : public System {
+
+private:
+
+	ParticlePool pool;
+	std::vector<ParticleStyle> styles;
+	std::map<std::string, int> styleIDs;
+	std::mt19937 random{ std::random_device{}() };
+	// The tick the particles last moved by, drawing steps back along it to interpolate
+	float lastDeltaTime = 0.0f;
+
+	float vary(float value, float variance) {
+
+		if (variance <= 0.0f) {
+			return value;
+		}
+
+		return std::uniform_real_distribution<float>(value - variance, value + variance)(random);
+	}
+
+	void emit(int styleID, glm::vec2 position, glm::vec2 baseVelocity, const ParticleEmission& emission) {
+
+		const float angle = vary(emission.direction, emission.spread);
+		const float speed = vary(emission.speed, emission.speedVariance);
+		const SinCos turn = Trig::fastSinCos(angle);
+
+		ParticleSpawn particle{
+			position.x,
+			position.y,
+			baseVelocity.x + turn.cosine * speed,
+			baseVelocity.y + turn.sine * speed,
+			std::max(0.01f, vary(emission.lifetime, emission.lifetimeVariance)),
+			emission.drag,
+			angle,
+			static_cast<uint16_t>(styleID)
+		};
+
+		pool.spawn(particle);
+	}
+
+	static glm::vec2 getCentre(const TransformComponent& transform, const SpriteComponent& sprite) {
+		return transform.position + sprite.size * transform.scale * 0.5f;
+	}
+
+public:
+
+	ParticleSystem() {
+		requireComponent<TransformComponent>();
+		requireComponent<SpriteComponent>();
+		requireComponent<ParticleEmitterComponent>();
+	}
+
+	void subscribeToEvent(std::unique_ptr<EventBus>& eventBus) {
+		eventBus->subscribeToEvent<ParticleSystem, ImpactEvent>(this, &ParticleSystem::onImpact);
+	}
+
+	int addStyle(const std::string& name, const ParticleStyle& style) {
+
+		if (styleIDs.find(name) != styleIDs.end()) {
+			Logger::LogErr("Particle style already added with name: " + name);
+			return styleIDs[name];
+		}
+
+		const int styleID = static_cast<int>(styles.size());
+		styles.push_back(style);
+		styleIDs.emplace(name, styleID);
+
+		return styleID;
+	}
+
+	// -1 when no style was added with that name
+	int getStyleID(const std::string& name) const {
+
+		auto styleID = styleIDs.find(name);
+
+		if (styleID == styleIDs.end()) {
+			return -1;
+		}
+
+		return styleID->second;
+	}
+
+	void burst(int styleID, glm::vec2 position, int count, const ParticleEmission& emission) {
+
+		if (styleID < 0 || styleID >= static_cast<int>(styles.size())) {
+			return;
+		}
+
+		for (int i = 0; i < count; i++) {
+			emit(styleID, position, glm::vec2(0, 0), emission);
+		}
+	}
+
+	// Sparks fly back the way the projectile came
+	void onImpact(ImpactEvent& event) {
+
+		const auto& transform = event.projectile.getComponent<TransformComponent>();
+		const auto& sprite = event.projectile.getComponent<SpriteComponent>();
+		const bool isFriendly = event.projectile.getComponent<ProjectileComponent>().isFriendly;
+
+		ParticleEmission emission;
+		emission.lifetime = 0.25f;
+		emission.lifetimeVariance = 0.1f;
+		emission.speed = 140.0f;
+		emission.speedVariance = 60.0f;
+		emission.direction = static_cast<float>(transform.rotation) + 180.0f;
+		emission.spread = 50.0f;
+		emission.drag = 4.0f;
+
+		burst(getStyleID(isFriendly ? "sparkFriendly" : "sparkEnemy"), getCentre(transform, sprite), 8, emission);
+	}
+
+	void update(float deltaTime) {
+
+		for (auto& entity : getEntities()) {
+
+			auto& emitter = entity.getComponent<ParticleEmitterComponent>();
+
+			if (emitter.styleID == -1) {
+				emitter.styleID = getStyleID(emitter.style);
+
+				if (emitter.styleID == -1) {
+					continue;
+				}
+			}
+
+			emitter.accumulator += emitter.rate * deltaTime;
+
+			if (emitter.accumulator < 1.0f) {
+				continue;
+			}
+
+			const auto& transform = entity.getComponent<TransformComponent>();
+			const auto& sprite = entity.getComponent<SpriteComponent>();
+
+			// The offset and direction turn with the entity
+			const float rotation = static_cast<float>(transform.rotation);
+			const glm::vec2 position = getCentre(transform, sprite) + Affine2D::rotation(Trig::fastSinCos(rotation)).applyToVector(emitter.offset);
+
+			// Particles leave with the entity's speed so a trail does not lag behind it
+			glm::vec2 baseVelocity(0, 0);
+
+			if (entity.hasComponent<RigidBodyComponent>()) {
+				baseVelocity = entity.getComponent<RigidBodyComponent>().veclocity;
+			}
+
+			ParticleEmission emission = emitter.emission;
+			emission.direction += rotation;
+
+			for (; emitter.accumulator >= 1.0f; emitter.accumulator -= 1.0f) {
+				emit(emitter.styleID, position, baseVelocity, emission);
+			}
+		}
+
+		pool.update(deltaTime);
+		lastDeltaTime = deltaTime;
+	}
+
+	void submit(RenderQueue& renderQueue, std::unique_ptr<AssetStore>& assetStore, int offset, float alpha) {
+
+		const int count = pool.size();
+		const float* positionX = pool.getPositionX();
+		const float* positionY = pool.getPositionY();
+		const float* velocityX = pool.getVelocityX();
+		const float* velocityY = pool.getVelocityY();
+		const float* age = pool.getAge();
+		const float* lifetime = pool.getLifetime();
+		const float* rotation = pool.getRotation();
+		const uint16_t* particleStyles = pool.getStyles();
+
+		// Positions are a tick ahead of the frame, step back by the part not yet reached
+		const float stepBack = lastDeltaTime * (1.0f - alpha);
+
+		for (int i = 0; i < count; i++) {
+
+			auto& style = styles[particleStyles[i]];
+
+			if (style.textureID == -1) {
+				style.textureID = assetStore->getTextureID(style.assetid);
+
+				if (style.textureID == -1) {
+					continue;
+				}
+			}
+
+			const TextureInfo& texture = assetStore->getTextureInfo(style.textureID);
+			const float life = std::min(age[i] / lifetime[i], 1.0f);
+			const int frame = std::min(static_cast<int>(life * style.frameCount), style.frameCount - 1);
+			const float scale = 1.0f + (style.endScale - 1.0f) * life;
+			const float width = style.size.x * scale;
+			const float height = style.size.y * scale;
+
+			const SDL_Rect srcRect{ frame * style.frameWidth, 0, style.frameWidth, style.frameHeight };
+
+			const SDL_FRect dstRect{
+				positionX[i] - velocityX[i] * stepBack - width * 0.5f,
+				positionY[i] - velocityY[i] * stepBack - height * 0.5f + offset,
+				width,
+				height
+			};
+
+			SDL_Color color{ 255, 255, 255, 255 };
+
+			if (style.fadeOut) {
+				color.a = static_cast<Uint8>(255.0f * (1.0f - life));
+			}
+
+			// Other particles keep the angle they were launched at
+			const float angle = style.alignToVelocity
+				? Trig::fastAngleOf(velocityX[i], velocityY[i])
+				: rotation[i];
+
+			renderQueue.submitSprite(RenderPass::sprites, explosion, texture, srcRect, dstRect, angle, color);
+		}
+	}
+
+	int getParticleCount() const {
+		return pool.size();
+	}
+};
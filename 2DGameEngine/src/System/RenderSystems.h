@@ -3,6 +3,35 @@
 #include "../Components/Components.h"
 #include "../Helpers/Colours.h"
 #include "../Assets/AssetStore.h"
+#include "../Render/RenderQueue.h"
+#include "../Render/HUDRenderer.h"
+#include "../Text/TextLayout.h"
+#include <cmath>
+#include <vector>
+
+// Where a transform is drawn, alpha of the way from the previous tick to the current one
+inline glm::vec2 interpolatePosition(const TransformComponent& transform, float alpha) {
+	return glm::mix(transform.previousPosition, transform.position, alpha);
+}
+
+inline double interpolateRotation(const TransformComponent& transform, float alpha) {
+
+	// The short way round, so 350 to 10 degrees does not spin through 180
+	double difference = std::fmod(transform.rotation - transform.previousRotation, 360.0);
+
+	if (difference > 180.0) {
+		difference -= 360.0;
+	}
+	else if (difference < -180.0) {
+		difference += 360.0;
+	}
+
+	return transform.previousRotation + difference * alpha;
+}
+
+inline SDL_FRect toFRect(const SDL_Rect& rect) {
+	return SDL_FRect{ static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(rect.w), static_cast<float>(rect.h) };
+}
 
 class DebugBoxCollisionRenderer : public System {
 
@@ -13,21 +42,26 @@ public:
 		requireComponent<BoxColliderComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, int offset) {
+	void update(RenderQueue& renderQueue, const std::vector<Entity>& visibleEntities, int offset, float alpha) {
+
+		for (const auto& entity : visibleEntities) {
+
+			if (!entity.hasComponent<BoxColliderComponent>()) {
+				continue;
+			}
 
-		for (const auto& entity : getEntities()) {
 			const auto& transformComponent = entity.getComponent<TransformComponent>();
 			const auto& boxComponent = entity.getComponent<BoxColliderComponent>();
+			const glm::vec2 position = interpolatePosition(transformComponent, alpha);
 
 			SDL_Rect rect = {
-				static_cast<int>(transformComponent.position.x) + static_cast<int>(boxComponent.offset.x),
-				static_cast<int>(transformComponent.position.y) + static_cast<int>(boxComponent.offset.y) + offset,
+				static_cast<int>(position.x) + static_cast<int>(boxComponent.offset.x),
+				static_cast<int>(position.y) + static_cast<int>(boxComponent.offset.y) + offset,
 				boxComponent.width * static_cast<int>(transformComponent.scale.x),
 				boxComponent.height * static_cast<int>(transformComponent.scale.y)
 			};
 
-			SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-			SDL_RenderDrawRect(renderer, &rect);
+			renderQueue.submitRect(RenderPass::debug, entity.getLayer(), toFRect(rect), Color::RED, false);
 		}
 	}
 };
@@ -40,81 +74,44 @@ public:
 		requireComponent<HUDComponent>();
 	}
 
-	void update(std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer) {
+	// Copies what the HUD shows into the frame, the renderer draws it from there. Text goes in laid out, a line per element
+	void update(std::vector<HUDElement>& hud, const AssetStore& assetStore) {
 
 		for (auto& entity : getEntities()) {
-			
-			const auto& hudComponent = entity.getComponent<HUDComponent>();
 
+			const auto& hudComponent = entity.getComponent<HUDComponent>();
 			const auto& textLabelComponent = hudComponent.textLabelComponent;
 
 			if (textLabelComponent != nullptr) {
-							
-				TTF_Font* font = assetStore->getFont(textLabelComponent->assetid);
-
-				SDL_Surface* surface = TTF_RenderText_Blended(
-					font, 
-					textLabelComponent->text.c_str(), 
-					textLabelComponent->textColor
-					);
-
-				SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);	
-					if (texture == NULL) {
-						Logger::LogErr(SDL_GetError());
-					}
 
-				SDL_FreeSurface(surface);
+				const GlyphAtlas* glyphAtlas = assetStore.getGlyphAtlas(textLabelComponent->assetid);
 
-				int labelWidth = 0;
-				int labelHeight = 0;
-
-				if (SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight) != 0) {
-					Logger::LogErr(SDL_GetError());
+				if (glyphAtlas == nullptr) {
+					continue;
 				}
 
-				SDL_Rect dstRect = {
-					static_cast<int>(textLabelComponent->position.x),
-					static_cast<int>(textLabelComponent->position.y),
-					labelWidth,
-					labelHeight	
-				};
+				const TextBlock block = TextLayout::layout(*glyphAtlas, textLabelComponent->text, textLabelComponent->align, textLabelComponent->wrapWidth);
 
-				SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-				SDL_DestroyTexture(texture);
-				texture = nullptr;
+				for (const auto& line : block.lines) {
+
+					// An element without text is an image
+					if (line.length == 0) {
+						continue;
+					}
 
+					hud.push_back({
+						textLabelComponent->assetid,
+						textLabelComponent->text.substr(line.start, line.length),
+						textLabelComponent->textColor,
+						textLabelComponent->position + glm::vec2(line.x, line.y),
+						glm::vec2(0, 0) });
+				}
 			}
 			else {
-				
-				SDL_Texture* texture = assetStore->getTexture(hudComponent.assetid);
-
-				SDL_Rect srcRect = {
-					0,
-					0,
-					static_cast<int>(hudComponent.size.x),
-					static_cast<int>(hudComponent.size.y)
-				};
-			
-				SDL_FRect dstRect = {
-					hudComponent.position.x,
-					hudComponent.position.y,
-					hudComponent.size.x,
-					hudComponent.size.y
-				};
-
-				SDL_RenderCopyExF(
-					renderer,
-					texture,
-					&srcRect,
-					&dstRect,
-					0,
-					NULL,
-					SDL_FLIP_NONE);
-				
+				hud.push_back({ hudComponent.assetid, "", SDL_Color{ 0, 0, 0, 0 }, hudComponent.position, hudComponent.size });
 			}
 		}
 	}
-
 };
 
 class TextRenderSystem : public System {
@@ -125,45 +122,39 @@ public:
 		requireComponent<TextLabelComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, int offset) {
-
-		for (auto& entity : getEntities()) {
-
-			const auto& textLabelComponent = entity.getComponent<TextLabelComponent>();
-			
-			TTF_Font* font = assetStore->getFont(textLabelComponent.assetid);
+	void update(RenderQueue& renderQueue, std::unique_ptr<AssetStore>& assetStore, const std::vector<Entity>& visibleEntities, int offset, float alpha) {
 
-			SDL_Surface* surface = TTF_RenderText_Blended(
-				font, 
-				textLabelComponent.text.c_str(), 
-				textLabelComponent.textColor
-				);
+		for (const auto& entity : visibleEntities) {
 
-			SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);	
-			if (texture == NULL) {
-				Logger::LogErr(SDL_GetError());
+			if (!entity.hasComponent<TextLabelComponent>()) {
+				continue;
 			}
 
-			SDL_FreeSurface(surface);
+			const auto& textLabelComponent = entity.getComponent<TextLabelComponent>();
+			const auto& transformComponent = entity.getComponent<TransformComponent>();
 
-			int labelWidth = 0;
-			int labelHeight = 0;
+			// Labels follow their entity, so they are moved back by as much as it is
+			const glm::vec2 position = textLabelComponent.position + interpolatePosition(transformComponent, alpha) - transformComponent.position;
+			
+			const GlyphAtlas* glyphAtlas = assetStore->getGlyphAtlas(textLabelComponent.assetid);
 
-			if (SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight) != 0) {
-				Logger::LogErr(SDL_GetError());
+			if (glyphAtlas == nullptr) {
+				continue;
 			}
 
-			SDL_Rect dstRect = {
-				static_cast<int>(textLabelComponent.position.x),
-				static_cast<int>(textLabelComponent.position.y) + offset,
-				labelWidth,
-				labelHeight	
-			};
-
-			SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-			SDL_DestroyTexture(texture);
-			texture = nullptr;
-
+			const TextBlock block = TextLayout::layout(*glyphAtlas, textLabelComponent.text, textLabelComponent.align, textLabelComponent.wrapWidth);
+
+			// Labels are laid out from whole pixels so the glyphs stay sharp
+			for (const auto& line : block.lines) {
+				renderQueue.submitText(
+					RenderPass::text,
+					entity.getLayer(),
+					*glyphAtlas,
+					textLabelComponent.text.substr(line.start, line.length),
+					static_cast<int>(position.x) + line.x,
+					static_cast<int>(position.y) + line.y + offset,
+					textLabelComponent.textColor);
+			}
 		}
 	}
 };
@@ -178,17 +169,22 @@ public:
 		requireComponent<SpriteComponent>();
 	}
 
-	void update(SDL_Renderer* renderer, int offset) {
+	void update(RenderQueue& renderQueue, const std::vector<Entity>& visibleEntities, int offset, float alpha) {
+
+		for (const auto& entity : visibleEntities) {
 
-		for (const auto& entity : getEntities()) {
+			if (!entity.hasComponent<HealthComponent>()) {
+				continue;
+			}
 
 			const auto& healthComponent = entity.getComponent<HealthComponent>();
 			const auto& transformComponent = entity.getComponent<TransformComponent>();
 			const auto& spriteComponent = entity.getComponent<SpriteComponent>();
+			const glm::vec2 position = interpolatePosition(transformComponent, alpha);
 
 			SDL_Rect rect = {
-				static_cast<int>(transformComponent.position.x),
-				static_cast<int>(transformComponent.position.y) + spriteComponent.srcRect.h + offset,
+				static_cast<int>(position.x),
+				static_cast<int>(position.y) + spriteComponent.srcRect.h + offset,
 				static_cast<int>(static_cast<float>(spriteComponent.srcRect.w) * healthComponent.health),
 				3
 			};
@@ -203,83 +199,7 @@ public:
 				color = Color::RED;
 			}
 
-			SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
-			SDL_RenderFillRect(renderer, &rect);
-
-		}
-	}
-};
-
-class ScrollingBackgroundRenderSystem : public System {
-
-private:
-	
-	float speed = 2.0f;
-
-public:
-
-	ScrollingBackgroundRenderSystem() {
-		requireComponent<BackgroundComponent>();
-	}
-
-	void update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, float deltaTime, int offset) {
-
-		float floatOffset = static_cast<float>(offset);
-
-		for (auto& entity : getEntities()) {
-			auto& backgroundComponent = entity.getComponent<BackgroundComponent>();
-			const auto& texture = assetStore->getTexture(backgroundComponent.assetID);
-
-			backgroundComponent.background.x -= deltaTime * speed;
-
-			if (backgroundComponent.background.x <= -backgroundComponent.background.w) {
-
-			}
-
-			SDL_Rect srcRect{
-				0,
-				0,
-				(int)backgroundComponent.background.w,
-				(int)backgroundComponent.background.h
-			};
-			
-			SDL_FRect dstRect{
-				backgroundComponent.background.x,
-				floatOffset, 
-				backgroundComponent.background.w,
-				backgroundComponent.background.h 
-			};
-
-			SDL_FRect dstRect2 {
-				backgroundComponent.background.x + backgroundComponent.background.w,
-				floatOffset,
-				backgroundComponent.background.w,
-				backgroundComponent.background.h 
-			};
-
-			backgroundComponent.background.x -= deltaTime * speed;
-
-			if (backgroundComponent.background.x <= -backgroundComponent.background.w) {
-				backgroundComponent.background.x += backgroundComponent.background.w;
-			}
-
-			SDL_RenderCopyExF(
-				renderer,
-				texture,
-				&srcRect,
-				&dstRect,
-				NULL,
-				NULL,
-				SDL_FLIP_NONE);
-
-			SDL_RenderCopyExF(
-				renderer,
-				texture,
-				&srcRect,
-				&dstRect2,
-				0,
-				NULL,
-				SDL_FLIP_NONE);
+			renderQueue.submitRect(RenderPass::overlays, entity.getLayer(), toFRect(rect), color, true);
 		}
 	}
 };
@@ -293,24 +213,30 @@ class RenderSystem : public System {
 			requireComponent<TransformComponent>();
 		}
 
-		void update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, int offset) {
+		void update(RenderQueue& renderQueue, std::unique_ptr<AssetStore>& assetStore, const std::vector<Entity>& visibleEntities, int offset, float alpha) {
 
-			std::vector enteties = getEntities();
-
-			for (auto& entity : enteties) {
+			for (const auto& entity : visibleEntities) {
 
 				const auto& transformComponent = entity.getComponent<TransformComponent>();
+				const glm::vec2 position = interpolatePosition(transformComponent, alpha);
 				auto& spriteComponent = entity.getComponent<SpriteComponent>();
 
-				const auto& texture = assetStore->getTexture(spriteComponent.assetid);
+				if (spriteComponent.textureID == -1) {
+					spriteComponent.textureID = assetStore->getTextureID(spriteComponent.assetid);
+
+					if (spriteComponent.textureID == -1) {
+						continue;
+					}
+				}
+
+				const TextureInfo& texture = assetStore->getTextureInfo(spriteComponent.textureID);
 
 				// Set the source rectangele of our original sprite texture
 				SDL_Rect srcRect = spriteComponent.srcRect;
 
 				if (srcRect.w == 0 && srcRect.h == 0) {
-					if (SDL_QueryTexture(texture, NULL, NULL, &srcRect.w, &srcRect.h) != 0) {
-						Logger::LogErr(SDL_GetError());
-					}
+					srcRect.w = texture.width;
+					srcRect.h = texture.height;
 				}
 
 				if (spriteComponent.size == glm::vec2(0, 0)) {
@@ -319,20 +245,13 @@ class RenderSystem : public System {
 
 				// Set the destination rectangle with the x and y position to be rendered
 				SDL_FRect dstRect = {
-					transformComponent.position.x,
-					transformComponent.position.y + offset,
+					position.x,
+					position.y + offset,
 					spriteComponent.size.x * transformComponent.scale.x,
 					spriteComponent.size.y * transformComponent.scale.x
 				};
 
-				SDL_RenderCopyExF(
-					renderer,
-					texture,
-					&srcRect,
-					&dstRect,
-					transformComponent.rotation,
-					NULL,
-					SDL_FLIP_NONE);
+				renderQueue.submitSprite(RenderPass::sprites, entity.getLayer(), texture, srcRect, dstRect, static_cast<float>(interpolateRotation(transformComponent, alpha)));
 			}
 		}	
 };
@@ -0,0 +1,103 @@
+#pragma once
+#include "../ECS/ESC.h"
+#include "../Components/Components.h"
+#include "../Collision/SpatialIndex.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+// Query filter bit of an entity layer
+inline uint32_t layerBit(Layer layer) {
+	return 1u << layer;
+}
+
+const uint32_t ALL_LAYERS = 0xFFFFFFFFu;
+
+/// <summary>
+/// Keeps a spatial index of every drawn entity, rebuilt once per frame from
+/// the transforms, so any system can ask what is near a point or in an area
+/// without going through an entity list. Results are valid until the next update
+/// </summary>
+class SpatialIndexSystem : public System {
+
+private:
+
+	SpatialIndex spatialIndex;
+	std::vector<SpatialItem> items;
+	std::vector<Entity> entities;
+	std::vector<int> results;
+
+	std::vector<Entity> toEntities(const std::vector<int>& indices) const {
+
+		std::vector<Entity> found;
+		found.reserve(indices.size());
+
+		for (int index : indices) {
+			found.push_back(entities[index]);
+		}
+
+		return found;
+	}
+
+public:
+
+	SpatialIndexSystem() {
+		requireComponent<TransformComponent>();
+		requireComponent<SpriteComponent>();
+	}
+
+	void update() {
+
+		entities = getEntities();
+		items.clear();
+
+		for (const auto& entity : entities) {
+			const auto& transform = entity.getComponent<TransformComponent>();
+			const auto& sprite = entity.getComponent<SpriteComponent>();
+
+			// The rectangle the render system draws the sprite in
+			const glm::vec2 size = sprite.size * transform.scale.x;
+
+			items.push_back({
+				AABB{ transform.position.x, transform.position.y, transform.position.x + size.x, transform.position.y + size.y },
+				layerBit(entity.getLayer())
+			});
+		}
+
+		spatialIndex.build(items);
+	}
+
+	std::vector<Entity> queryRect(glm::vec2 min, glm::vec2 max, uint32_t layerMask = ALL_LAYERS) {
+		results.clear();
+		spatialIndex.queryRect(AABB{ min.x, min.y, max.x, max.y }, layerMask, results);
+		return toEntities(results);
+	}
+
+	std::vector<Entity> queryRadius(glm::vec2 centre, float radius, uint32_t layerMask = ALL_LAYERS) {
+		results.clear();
+		spatialIndex.queryRadius(centre.x, centre.y, radius, layerMask, results);
+		return toEntities(results);
+	}
+
+	// Nearest first
+	std::vector<Entity> nearestK(glm::vec2 point, int k, uint32_t layerMask = ALL_LAYERS, float maxDistance = 1e30f) {
+		results.clear();
+		spatialIndex.nearestK(point.x, point.y, k, layerMask, results, maxDistance);
+		return toEntities(results);
+	}
+
+	// First entity along the ray, or null. distance is set to how far along the ray it was hit
+	const Entity* raycast(glm::vec2 origin, glm::vec2 direction, float maxDistance, uint32_t layerMask = ALL_LAYERS, float* distance = nullptr) {
+
+		SpatialRayHit hit;
+
+		if (!spatialIndex.raycast(origin.x, origin.y, direction.x, direction.y, maxDistance, layerMask, hit)) {
+			return nullptr;
+		}
+
+		if (distance) {
+			*distance = hit.distance;
+		}
+
+		return &entities[hit.item];
+	}
+};
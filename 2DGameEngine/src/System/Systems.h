@@ -6,12 +6,49 @@
 #include "../Logger/Logger.h"
 #include <glm/glm.hpp>
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iterator>
+#include <map>
+#include <queue>
 #include <random>
 #include <string>
 #include "../Helpers/Helpers.h"
 #include "../Helpers/Colours.h"
+#include "../Collision/Broadphase.h"
+#include "../Collision/ColliderRecording.h"
+#include "../Collision/CollisionDetector.h"
+#include "../Collision/ContactCache.h"
+#include "../Collision/SweptCollision.h"
+#include "../Animation/AnimationClip.h"
+#include "../Math/Affine2D.h"
+#include "ParticleSystem.h"
+#include "../Threading/WorkerPool.h"
+
+
+/// <summary>
+/// Remembers every transform at the start of a tick, so drawing can blend
+/// between the last two ticks when the display runs faster than the simulation
+/// </summary>
+class TransformHistorySystem : public System {
 
+public:
+
+	TransformHistorySystem() {
+		requireComponent<TransformComponent>();
+	}
+
+	void update() {
+
+		for (auto& entity : getEntities()) {
+
+			auto& transform = entity.getComponent<TransformComponent>();
+
+			transform.previousPosition = transform.position;
+			transform.previousRotation = transform.rotation;
+		}
+	}
+};
 
 class MovementSystem : public System {
 
@@ -36,37 +73,126 @@ public:
 
 class AnimationSystem : public System {
 
+private:
+
+	// When an entity next changes frame. Entries outlive their playback, the play id tells which are stale
+	struct FrameChange {
+		int time;
+		Entity entity;
+		int playID;
+
+		bool operator >(const FrameChange& other) const {
+			return time > other.time;
+		}
+	};
+
+	std::vector<AnimationClip> clips;
+	std::map<std::string, int> clipIDs;
+	std::priority_queue<FrameChange, std::vector<FrameChange>, std::greater<FrameChange>> frameChanges;
+	int nextPlayID = 1;
+
 public:
+
 	AnimationSystem() {
 		requireComponent<AnimationComponent>();
 		requireComponent<SpriteComponent>();
 	}
 
+	int addClip(const std::string& name, const AnimationClip& clip) {
+
+		if (clipIDs.find(name) != clipIDs.end()) {
+			Logger::LogErr("Animation clip already added with name: " + name);
+			return clipIDs[name];
+		}
+
+		if (clip.isEmpty()) {
+			Logger::LogErr("Animation clip has no frames: " + name);
+			return -1;
+		}
+
+		const int clipID = static_cast<int>(clips.size());
+		clips.push_back(clip);
+		clipIDs.emplace(name, clipID);
+
+		return clipID;
+	}
+
+	// -1 when no clip was added with that name
+	int getClipID(const std::string& name) const {
+
+		auto clipID = clipIDs.find(name);
+
+		if (clipID == clipIDs.end()) {
+			return -1;
+		}
+
+		return clipID->second;
+	}
+
+	// Starts the clip from its first frame, replacing whatever the entity was playing
+	void play(Entity entity, const std::string& name) {
+
+		const int clipID = getClipID(name);
+
+		if (clipID == -1) {
+			Logger::LogErr("No animation clip with name: " + name);
+			return;
+		}
+
+		const int playID = nextPlayID++;
+		entity.addComponent<AnimationComponent>(clipID, playID);
+
+		const auto& animationComponent = entity.getComponent<AnimationComponent>();
+		const auto& clip = clips[clipID];
+
+		entity.getComponent<SpriteComponent>().srcRect = clip.frames[0];
+		frameChanges.push({ animationComponent.startTime + clip.frameEnds[0], entity, playID });
+	}
+
+	// Only entities whose frame is due are touched, the rest cost nothing until then
 	void animate(std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry) {
 
-		for (auto& entity : getEntities()) {
+		const int now = static_cast<int>(SimulationClock::getTicks());
+
+		while (!frameChanges.empty() && frameChanges.top().time <= now) {
+
+			const FrameChange frameChange = frameChanges.top();
+			frameChanges.pop();
+
+			Entity entity = frameChange.entity;
+
+			if (!entity.hasComponent<AnimationComponent>()) {
+				continue;
+			}
 
-			auto& spriteComponent = entity.getComponent<SpriteComponent>();
 			auto& animationComponent = entity.getComponent<AnimationComponent>();
 
-			animationComponent.currentFrame = ((SDL_GetTicks() - animationComponent.startTime) 
-					* animationComponent.frameSpeedRate / 1000) 
-					% animationComponent.numFrames;
+			if (animationComponent.playID != frameChange.playID) {
+				continue;
+			}
 
-			spriteComponent.srcRect.x = static_cast<int>(spriteComponent.size.x) * animationComponent.currentFrame;
+			const auto& clip = clips[animationComponent.clipID];
+			const int duration = clip.getDuration();
+			const int elapsed = now - animationComponent.startTime;
 
-			if (!animationComponent.isLoop) {
+			// A long tick can pass several frames, this lands on the one showing now
+			const int loopsCompleted = elapsed / duration;
+			const bool isComplete = clip.loopCount > 0 && loopsCompleted >= clip.loopCount;
+			const int frame = isComplete ? static_cast<int>(clip.frames.size()) - 1 : clip.getFrameAt(elapsed % duration);
 
-				if (animationComponent.loopsCompleted < animationComponent.loopCount) {
+			if (frame != animationComponent.currentFrame) {
+				animationComponent.currentFrame = frame;
+				entity.getComponent<SpriteComponent>().srcRect = clip.frames[frame];
+			}
 
-					animationComponent.loopsCompleted++;
-				}
-				else {
-					entity.kill();
-					entity.getLayer() == playerShield ? eventBus->publishEvent<RestoreBoxColliderEvent>(registry) : void();
-				}
-				
+			animationComponent.loopsCompleted = isComplete ? clip.loopCount : loopsCompleted;
+
+			if (isComplete) {
+				eventBus->publishEvent<AnimationCompleteEvent>(entity, eventBus, registry);
+				continue;
 			}
+
+			frameChanges.push({ animationComponent.startTime + loopsCompleted * duration + clip.frameEnds[frame], entity, frameChange.playID });
 		}
 	}
 };
@@ -75,68 +201,145 @@ class BoxColliderSystem : public System {
 
 private:
 
-	bool checkCollision(
-		TransformComponent& aTransform,
-		BoxColliderComponent& aBoxCollider,
-		TransformComponent& bTransform,
-		BoxColliderComponent& bBoxCollider) {
+	CollisionDetector collisionDetector;
+	std::vector<ColliderProxy> proxies;
+	std::vector<CandidatePair> contacts;
+	ContactCache contactCache;
+
+	std::function<void(Entity&, Entity&)> contactStayCallback;
+	std::function<void(int, int)> contactEndCallback;
+
+	CollisionMatrix collisionMatrix = CollisionMatrix::createDefault();
 
-		int aX = (int)aTransform.position.x + (int)aBoxCollider.offset.x;
-		int aY = (int)aTransform.position.y + (int)aBoxCollider.offset.y;
-		int aMaxX = aX + aBoxCollider.width;
-		int aMaxY = aY + aBoxCollider.height;
+	ColliderRecording recording;
+	bool isRecording = false;
 
-		int bX = (int)bTransform.position.x + (int)bBoxCollider.offset.x;
-		int bY = (int)bTransform.position.y + (int)bBoxCollider.offset.y;
-		int bMaxX = bX + bBoxCollider.width;
-		int bMaxY = bY + bBoxCollider.height;
+	// Where each continuous collider was in the frame it was last seen, by entity id
+	std::vector<glm::vec2> previousPositions;
+	std::vector<int> lastSeenFrames;
+	int frame = 0;
 
-		return (aX < bMaxX && aMaxX > bX && aY < bMaxY && aMaxY > bY);
+	AABB getBoundingBox(const TransformComponent& transform, const BoxColliderComponent& boxCollider) {
 
+		float x = transform.position.x + boxCollider.offset.x;
+		float y = transform.position.y + boxCollider.offset.y;
+
+		return AABB{
+			x,
+			y,
+			x + static_cast<float>(boxCollider.width),
+			y + static_cast<float>(boxCollider.height)
+		};
 	}
 	
+	const SpriteMask* getSpriteMask(const Entity& entity, SpriteMaskCache& spriteMasks) {
+
+		const auto& transform = entity.getComponent<TransformComponent>();
+		const auto& sprite = entity.getComponent<SpriteComponent>();
+
+		// Same size and rotation the render system draws the sprite with
+		return spriteMasks.getMask(
+			sprite.assetid,
+			sprite.srcRect.x,
+			sprite.srcRect.y,
+			sprite.srcRect.w,
+			sprite.srcRect.h,
+			static_cast<int>(std::lround(sprite.size.x * transform.scale.x)),
+			static_cast<int>(std::lround(sprite.size.y * transform.scale.x)),
+			transform.rotation);
+	}
+
+	// Whether the solid pixels of two entities with overlapping boxes touch.
+	// Entities without a sprite mask keep their box hit
+	bool pixelsOverlap(const Entity& a, const ColliderProxy& proxyA, const Entity& b, const ColliderProxy& proxyB, SpriteMaskCache& spriteMasks) {
+
+		if (!a.hasComponent<SpriteComponent>() || !b.hasComponent<SpriteComponent>()) {
+			return true;
+		}
+
+		const SpriteMask* maskA = getSpriteMask(a, spriteMasks);
+		const SpriteMask* maskB = getSpriteMask(b, spriteMasks);
+
+		if (maskA == nullptr || maskB == nullptr) {
+			return true;
+		}
+
+		const glm::vec2 positionA = a.getComponent<TransformComponent>().position;
+		const glm::vec2 positionB = b.getComponent<TransformComponent>().position;
+
+		// Swept colliders are tested at a few points of the part of the move where their boxes overlapped
+		float enterTime = 1.0f;
+		float exitTime = 1.0f;
+		int steps = 0;
+
+		if (proxyA.deltaX != 0.0f || proxyA.deltaY != 0.0f || proxyB.deltaX != 0.0f || proxyB.deltaY != 0.0f) {
+			sweptOverlap(proxyA, proxyB, &enterTime, &exitTime);
+			const float distance = std::max(std::abs(proxyA.deltaX - proxyB.deltaX), std::abs(proxyA.deltaY - proxyB.deltaY)) * (exitTime - enterTime);
+			steps = std::min(static_cast<int>(std::ceil(distance)), 16);
+		}
+
+		for (int step = 0; step <= steps; step++) {
+
+			const float time = steps == 0 ? exitTime : enterTime + (exitTime - enterTime) * step / steps;
+
+			const int ax = static_cast<int>(std::lround(positionA.x - proxyA.deltaX * (1.0f - time)));
+			const int ay = static_cast<int>(std::lround(positionA.y - proxyA.deltaY * (1.0f - time)));
+			const int bx = static_cast<int>(std::lround(positionB.x - proxyB.deltaX * (1.0f - time)));
+			const int by = static_cast<int>(std::lround(positionB.y - proxyB.deltaY * (1.0f - time)));
+
+			if (SpriteMask::overlap(*maskA, ax, ay, *maskB, bx, by)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
 	void handleCollision(
 		Entity& a, 
+		uint32_t aCategory,
 		Entity& b, 
+		uint32_t bCategory,
 		std::unique_ptr<EventBus>& eventBus, 
 		std::unique_ptr<Registry>& registry,
 		std::unique_ptr<AssetStore>& assetStore) {
 
-		// Handle collision between a and b
+		// Handle collision between a and b. The collision matrix has already
+		// thrown away every pair the game does not respond to
 
-		// Check if either entity is a projectile
-		bool aIsProjectile = a.hasComponent<ProjectileComponent>();
-		bool bIsProjectile = b.hasComponent<ProjectileComponent>();
+		const uint32_t projectileCategories = CATEGORY_PLAYER_PROJECTILE | CATEGORY_ENEMY_PROJECTILE;
 
-		if (aIsProjectile || bIsProjectile) {
+		// Check if either entity is a projectile
+		if ((aCategory | bCategory) & projectileCategories) {
+			bool aIsProjectile = aCategory & projectileCategories;
 			Entity& projectile = aIsProjectile ? a : b;
 			Entity& other = aIsProjectile ? b : a;
+			uint32_t otherCategory = aIsProjectile ? bCategory : aCategory;
 			auto& projectileComponent = projectile.getComponent<ProjectileComponent>();
 
-			// Friendly projectile hitting player
-			if (other.getLayer() == player && projectileComponent.isFriendly) {
-				return;
-			}
+			eventBus->publishEvent<ImpactEvent>(projectile);
 
 			// Enemy projectile hitting player
-			if (other.getLayer() == player && !projectileComponent.isFriendly) {
+			if (otherCategory & CATEGORY_PLAYER) {
 				eventBus->publishEvent<UpdateHealthEvent>(projectileComponent.hitPercentDamage, eventBus, registry, assetStore, PLAYER, other);
 				projectile.kill();
 				return;
 			}
 
 			// Friendly projectile hitting enemy
-			if (other.getLayer() == enemy && projectileComponent.isFriendly) {
+			if (otherCategory & CATEGORY_ENEMY) {
 				eventBus->publishEvent<UpdateHealthEvent>(projectileComponent.hitPercentDamage, eventBus, registry, assetStore, ENEMY, other);
 				projectile.kill();
 				return;
 			}
+
+			return;
 		}
 
 		// Handle player collisions. Player loses life.
-		if (a.getLayer() == player || b.getLayer() == player) {
-			Entity& playerEntity = (a.getLayer() == player) ? a : b;
-			Entity& otherEntity = (a.getLayer() == player) ? b : a;
+		if ((aCategory | bCategory) & CATEGORY_PLAYER) {
+			Entity& playerEntity = (aCategory & CATEGORY_PLAYER) ? a : b;
+			Entity& otherEntity = (aCategory & CATEGORY_PLAYER) ? b : a;
 			eventBus->publishEvent<LifeLostEvent>(1, playerEntity, eventBus, registry, assetStore);
 			otherEntity.kill();
 			eventBus->publishEvent<SoundEffectEvent>(assetStore, "enemyExplosion");
@@ -150,23 +353,113 @@ public:
 		requireComponent<TransformComponent>();
 		requireComponent<BoxColliderComponent>();
 	}
+
+	void setBroadphase(BroadphaseType type) {
+		collisionDetector.setBroadphase(type);
+	}
+
+	BroadphaseType getBroadphaseType() const {
+		return collisionDetector.getBroadphaseType();
+	}
+
+	// Decides which collider categories are tested against each other at all
+	CollisionMatrix& getCollisionMatrix() {
+		return collisionMatrix;
+	}
+
+	// Called every frame for each contact that began in an earlier frame and still overlaps
+	void setContactStayCallback(std::function<void(Entity& a, Entity& b)> callback) {
+		contactStayCallback = callback;
+		contactCache.setTrackingStay(static_cast<bool>(callback));
+	}
+
+	// Called once when two colliders stop overlapping, including when either entity
+	// has left the system, so the ids may belong to dead entities
+	void setContactEndCallback(std::function<void(int entityA, int entityB)> callback) {
+		contactEndCallback = callback;
+	}
+
+	// Starts recording the colliders of every frame, or stops and saves the recording
+	void toggleRecording(const std::string& filePath) {
+
+		if (isRecording) {
+			recording.save(filePath);
+			recording.clear();
+		}
+
+		isRecording = !isRecording;
+	}
 	
-	void update(std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry, std::unique_ptr<AssetStore>& assetStore) {
+	void update(std::unique_ptr<EventBus>& eventBus, std::unique_ptr<Registry>& registry, std::unique_ptr<AssetStore>& assetStore, std::unique_ptr<WorkerPool>& workerPool) {
 		std::vector<Entity> entities = getEntities();
 
-		for (auto i = entities.begin(); i != entities.end(); i++) {
-			Entity a = *i;
-			TransformComponent& aTransform = a.getComponent<TransformComponent>();
-			BoxColliderComponent& aBoxCollider = a.getComponent<BoxColliderComponent>();
+		proxies.clear();
+		frame++;
 
-			for (auto j = i + 1; j != entities.end(); j++) {
-				Entity b = *j;
-				TransformComponent& bTransform = b.getComponent<TransformComponent>();
-				BoxColliderComponent& bBoxCollider = b.getComponent<BoxColliderComponent>();
+		for (const auto& entity : entities) {
+			const auto& transform = entity.getComponent<TransformComponent>();
+			const auto& boxCollider = entity.getComponent<BoxColliderComponent>();
 
-				if (checkCollision(aTransform, aBoxCollider, bTransform, bBoxCollider)) {
-					handleCollision(a, b, eventBus, registry, assetStore);
+			ColliderProxy proxy{
+				entity.getID(),
+				getBoundingBox(transform, boxCollider),
+				boxCollider.category,
+				collisionMatrix.getMask(boxCollider.category)
+			};
+
+			if (boxCollider.isContinuous) {
+				const int id = entity.getID();
+
+				if (id >= static_cast<int>(lastSeenFrames.size())) {
+					previousPositions.resize(id + 1);
+					lastSeenFrames.resize(id + 1, -1);
 				}
+
+				// Only sweep from last frame, an id seen longer ago belonged to an entity that was removed
+				if (lastSeenFrames[id] == frame - 1) {
+					proxy.deltaX = transform.position.x - previousPositions[id].x;
+					proxy.deltaY = transform.position.y - previousPositions[id].y;
+					proxy.box = sweepBox(proxy.box, proxy.deltaX, proxy.deltaY);
+				}
+
+				previousPositions[id] = transform.position;
+				lastSeenFrames[id] = frame;
+			}
+
+			proxies.push_back(proxy);
+		}
+
+		if (isRecording) {
+			recording.addFrame(proxies);
+		}
+
+		// Detection may run on the worker threads, the responses below change
+		// components and publish events so they stay on this thread
+		collisionDetector.detect(proxies, workerPool.get(), contacts);
+
+		// Boxes only bound the sprites, drop the hits where no solid pixels touch
+		SpriteMaskCache& spriteMasks = assetStore->getSpriteMasks();
+
+		contacts.erase(std::remove_if(contacts.begin(), contacts.end(), [&](const CandidatePair& contact) {
+			return !pixelsOverlap(entities[contact.a], proxies[contact.a], entities[contact.b], proxies[contact.b], spriteMasks);
+			}), contacts.end());
+
+		contactCache.update(contacts, proxies);
+
+		// Only new contacts get a response, a pair that keeps overlapping is handled once
+		for (const auto& contact : contactCache.getBegan()) {
+			handleCollision(entities[contact.a], proxies[contact.a].category, entities[contact.b], proxies[contact.b].category, eventBus, registry, assetStore);
+		}
+
+		if (contactStayCallback) {
+			for (const auto& contact : contactCache.getStayed()) {
+				contactStayCallback(entities[contact.a], entities[contact.b]);
+			}
+		}
+
+		if (contactEndCallback) {
+			for (const auto& pair : contactCache.getEnded()) {
+				contactEndCallback(pair.entityA, pair.entityB);
 			}
 		}
 	}
@@ -193,11 +486,28 @@ class ExplosionSystem : public System {
 
 private:
 
-	void createExplosion(std::unique_ptr<Registry>& registry, std::string assetid, glm::vec2 position) {
-		Entity playerExplosion = registry->createEntity(explosion);
-		playerExplosion.addComponent<TransformComponent>(position, glm::vec2(1, 1), 0);
-		playerExplosion.addComponent<SpriteComponent>(assetid, glm::vec2(32, 32));
-		playerExplosion.addComponent<AnimationComponent>(4, 10, false, 30);
+	// The explosion is particles now, so it never becomes an entity
+	void createExplosion(std::unique_ptr<Registry>& registry, const std::string& style, const std::string& debrisStyle, glm::vec2 position) {
+
+		auto& particleSystem = registry->getSystem<ParticleSystem>();
+
+		// The 32 by 32 explosion used to be drawn from position, particles are drawn from their centre
+		const glm::vec2 centre = position + glm::vec2(16, 16);
+
+		ParticleEmission flash;
+		flash.lifetime = 0.4f;
+		flash.spread = 0.0f;
+
+		particleSystem.burst(particleSystem.getStyleID(style), centre, 1, flash);
+
+		ParticleEmission debris;
+		debris.lifetime = 0.5f;
+		debris.lifetimeVariance = 0.2f;
+		debris.speed = 90.0f;
+		debris.speedVariance = 60.0f;
+		debris.drag = 2.0f;
+
+		particleSystem.burst(particleSystem.getStyleID(debrisStyle), centre, 24, debris);
 	}
 
 public:
@@ -216,10 +526,10 @@ public:
 		
 			switch (event.entityType) {
 			case PLAYER:
-				createExplosion(event.registry, "playerExplosion", transformComponent.position);
+				createExplosion(event.registry, "explosionPlayer", "sparkFriendly", transformComponent.position);
 				break;
 			case ENEMY:
-				createExplosion(event.registry, "enemyExplosion", transformComponent.position);
+				createExplosion(event.registry, "explosionEnemy", "sparkEnemy", transformComponent.position);
 				break;
 			}
 		}
@@ -319,31 +629,39 @@ public:
 			const auto& spriteComponent = entity.getComponent<SpriteComponent>();
 			auto& projectileEmitterComponent = entity.getComponent<ProjectileEmitterComponent>();
 
-			if (static_cast<int>(SDL_GetTicks()) - projectileEmitterComponent.lastEmissionTime > projectileEmitterComponent.repeatFrequency) {
+			if (static_cast<int>(SimulationClock::getTicks()) - projectileEmitterComponent.lastEmissionTime > projectileEmitterComponent.repeatFrequency) {
 
-				glm::vec2 projectilePosition = Helper::calculcatePosition(transformComponent, spriteComponent, projectileEmitterComponent.direction.x);
-				
-				double radians = glm::radians(transformComponent.rotation) * projectileEmitterComponent.direction.x;
+				// The shot leaves from the middle of the sprite's front edge, or its back when firing backwards
+				const glm::vec2 centre = transformComponent.position + spriteComponent.size * 0.5f;
+				const glm::vec2 muzzle = centre + glm::vec2(spriteComponent.size.x * 0.5f * projectileEmitterComponent.direction.x, 0.0f);
+				const float rotation = static_cast<float>(transformComponent.rotation);
 
-				glm::vec2 directionVector(glm::cos(radians), glm::sin(radians));
+				glm::vec2 projectilePosition = Affine2D::rotationAbout(centre, Trig::fastSinCos(std::ceil(rotation))).apply(muzzle);
 
-				Entity projectile = event.registry->createEntity(Layer::projectile);
+				const SinCos turn = Trig::fastSinCos(rotation * projectileEmitterComponent.direction.x);
+
+				glm::vec2 directionVector(turn.cosine, turn.sine);
 
-				double rotation = transformComponent.rotation;
+				Entity projectile = event.registry->createEntity(Layer::projectile);
 
 				projectile.addComponent<TransformComponent>(
 					projectilePosition,
 					glm::vec2(1, 1),
-					rotation);
+					transformComponent.rotation);
 
 				projectile.addComponent<SpriteComponent>(entity.getLayer() == player ? "playerLaser" : "enemyLaser");
 
-				glm::vec2 velocity = glm::normalize(directionVector) * projectileEmitterComponent.direction * projectileEmitterComponent.speed;
+				glm::vec2 velocity = directionVector * projectileEmitterComponent.direction * projectileEmitterComponent.speed;
 				projectile.addComponent<RigidBodyComponent>(velocity);
-				projectile.addComponent<BoxColliderComponent>(10, 2);
+				projectile.addComponent<BoxColliderComponent>(
+					10,
+					2,
+					glm::vec2(0, 0),
+					projectileEmitterComponent.isFriendly ? CATEGORY_PLAYER_PROJECTILE : CATEGORY_ENEMY_PROJECTILE,
+					true);
 				projectile.addComponent<ProjectileComponent>(projectileEmitterComponent.projectileDuration, projectileEmitterComponent.hitPercentDamage, projectileEmitterComponent.isFriendly);
 
-				projectileEmitterComponent.lastEmissionTime = SDL_GetTicks();
+				projectileEmitterComponent.lastEmissionTime = SimulationClock::getTicks();
 			}
 		}
 };
@@ -361,7 +679,7 @@ class ProjectilLifeTimeSystem : public System {
 			for (auto& entity : getEntities()) {
 				auto& projectileComponent = entity.getComponent<ProjectileComponent>();
 
-				if (static_cast<int>(SDL_GetTicks()) - projectileComponent.startTime > projectileComponent.projectileDuration) {
+				if (static_cast<int>(SimulationClock::getTicks()) - projectileComponent.startTime > projectileComponent.projectileDuration) {
 					entity.kill();
 				}
 			}
@@ -464,9 +782,9 @@ class LivesUpdateSystem : public System {
 				Entity shieldEntity = event.registry->createEntity(playerShield);
 				shieldEntity.addComponent<TransformComponent>(playerPosition.position, glm::vec2(1, 1), 0);
 				shieldEntity.addComponent<SpriteComponent>("playerLifeLost", glm::vec2(32, 32), glm::vec2(0, 0));
-				shieldEntity.addComponent<AnimationComponent>(4, 8, false, 200);
 				shieldEntity.addComponent<ShieldComponent>(std::make_shared<Entity>(event.playerEntity));
 				shieldEntity.addComponent<RigidBodyComponent>(glm::vec2(0.0f, 40.0f));
+				event.registry->getSystem<AnimationSystem>().play(shieldEntity, "shield");
 
 				auto& system = event.registry->getSystem<BoxColliderSystem>();
 				system.removeEntity(event.playerEntity);
@@ -501,6 +819,21 @@ public:
 		}
 	}
 
+	void subscribeToEvent(std::unique_ptr<EventBus>& eventBus) {
+		eventBus->subscribeToEvent<ShieldSystem, AnimationCompleteEvent>(this, &ShieldSystem::onAnimationComplete);
+	}
+
+	// The shield lasts as long as its animation, then the player can be hit again
+	void onAnimationComplete(AnimationCompleteEvent& event) {
+
+		if (!event.entity.hasComponent<ShieldComponent>()) {
+			return;
+		}
+
+		event.entity.kill();
+		event.eventBus->publishEvent<RestoreBoxColliderEvent>(event.registry);
+	}
+
 };
 
 class RestoreBoxColliderSystem : public System {
@@ -0,0 +1,68 @@
+#pragma once
+#include "../ECS/ESC.h"
+#include "../Components/Components.h"
+#include "../Render/TileMapRenderer.h"
+#include <algorithm>
+#include <vector>
+
+class TileMapSystem : public System {
+
+private:
+
+	// Pixels per second the level scrolls by, each layer moves by its parallax times this
+	float speed = 4.0f;
+
+public:
+
+	TileMapSystem() {
+		requireComponent<TileMapComponent>();
+	}
+
+	// Moves the layers on by one tick
+	void scroll(float deltaTime) {
+
+		for (auto& entity : getEntities()) {
+
+			auto& tileMapComponent = entity.getComponent<TileMapComponent>();
+
+			tileMapComponent.previousScroll = tileMapComponent.scroll;
+			tileMapComponent.scroll.x += deltaTime * speed * tileMapComponent.parallax;
+
+			if (!tileMapComponent.isRepeating || !tileMapComponent.tileMap) {
+				continue;
+			}
+
+			// Wrapping moves the previous scroll along, so drawing never blends across the jump
+			const float width = static_cast<float>(tileMapComponent.tileMap->getPixelWidth());
+
+			if (width > 0.0f && tileMapComponent.scroll.x >= width) {
+				tileMapComponent.scroll.x -= width;
+				tileMapComponent.previousScroll.x -= width;
+			}
+		}
+	}
+
+	// Copies where each layer is into the frame, the renderer draws the chunks
+	void update(std::vector<TileMapView>& tileMaps, int offset, float alpha) {
+
+		std::vector<Entity> layers = getEntities();
+
+		// Far layers scroll slowest and go first, the near ones are drawn over them
+		std::stable_sort(layers.begin(), layers.end(), [](const Entity& a, const Entity& b) {
+			return a.getComponent<TileMapComponent>().parallax < b.getComponent<TileMapComponent>().parallax;
+		});
+
+		for (const auto& entity : layers) {
+
+			const auto& tileMapComponent = entity.getComponent<TileMapComponent>();
+
+			if (!tileMapComponent.tileMap) {
+				continue;
+			}
+
+			const glm::vec2 scroll = glm::mix(tileMapComponent.previousScroll, tileMapComponent.scroll, alpha);
+
+			tileMaps.push_back({ tileMapComponent.tileMap, glm::vec2(-scroll.x, static_cast<float>(offset) - scroll.y), tileMapComponent.isRepeating });
+		}
+	}
+};
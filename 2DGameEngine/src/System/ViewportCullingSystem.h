@@ -0,0 +1,55 @@
+#pragma once
+#include "../ECS/ESC.h"
+#include "../Components/Components.h"
+#include "SpatialIndexSystem.h"
+#include <SDL.h>
+#include <algorithm>
+#include <vector>
+
+/// <summary>
+/// Finds the drawn entities that can be seen through the viewport, through
+/// the spatial index so entities off screen are never touched. The render
+/// systems draw from this visible set instead of their own entity lists
+/// </summary>
+class ViewportCullingSystem : public System {
+
+private:
+
+	// Health bars and labels hang below the sprite and labels are wider than
+	// small ships, so entities are kept a little past the edges
+	float margin = 64.0f;
+
+	std::vector<Entity> visibleEntities;
+
+	static bool sortByLayer(const Entity& entity1, const Entity& entity2) {
+		if (entity1.getLayer() != entity2.getLayer()) {
+			return entity1.getLayer() < entity2.getLayer();
+		}
+		return entity1.getID() < entity2.getID();
+	}
+
+public:
+
+	ViewportCullingSystem() {
+		requireComponent<TransformComponent>();
+		requireComponent<SpriteComponent>();
+	}
+
+	// viewport is the part of the world on screen, in world coordinates
+	void update(std::unique_ptr<Registry>& registry, const SDL_FRect& viewport) {
+
+		auto& spatialIndexSystem = registry->getSystem<SpatialIndexSystem>();
+
+		visibleEntities = spatialIndexSystem.queryRect(
+			glm::vec2(viewport.x - margin, viewport.y - margin),
+			glm::vec2(viewport.x + viewport.w + margin, viewport.y + viewport.h + margin));
+
+		// Drawn in layer order like the systems' own lists, and in a fixed order within a layer
+		std::sort(visibleEntities.begin(), visibleEntities.end(), sortByLayer);
+	}
+
+	// Every visible entity has a transform and a sprite, sorted by layer
+	const std::vector<Entity>& getVisibleEntities() const {
+		return visibleEntities;
+	}
+};
@@ -0,0 +1,66 @@
+#include "TextLayout.h"
+#include <algorithm>
+
+TextBlock TextLayout::layout(const GlyphAtlas& atlas, const std::string& text, TextAlign align, int maxWidth) {
+
+	TextBlock block;
+
+	auto addLine = [&](size_t start, size_t end) {
+
+		TextLine line;
+		line.start = start;
+		line.length = end - start;
+		line.width = atlas.measure(text.data() + start, line.length);
+		line.x = alignX(0, line.width, align);
+		line.y = static_cast<int>(block.lines.size()) * atlas.getLineHeight();
+
+		block.width = std::max(block.width, line.width);
+		block.lines.push_back(line);
+	};
+
+	size_t paragraphStart = 0;
+
+	while (paragraphStart <= text.size()) {
+
+		const size_t paragraphEnd = std::min(text.find('\n', paragraphStart), text.size());
+
+		size_t lineStart = paragraphStart;
+		// End of the last word that still fitted on the line
+		size_t lineEnd = paragraphStart;
+		size_t wordStart = paragraphStart;
+
+		while (wordStart < paragraphEnd) {
+
+			const size_t wordEnd = std::min(text.find(' ', wordStart), paragraphEnd);
+
+			// A word wider than the line on its own stays whole rather than being split
+			if (maxWidth > 0 && lineEnd > lineStart && atlas.measure(text.data() + lineStart, wordEnd - lineStart) > maxWidth) {
+				addLine(lineStart, lineEnd);
+				lineStart = wordStart;
+			}
+
+			lineEnd = wordEnd;
+			wordStart = wordEnd + 1;
+		}
+
+		addLine(lineStart, std::max(lineEnd, lineStart));
+
+		paragraphStart = paragraphEnd + 1;
+	}
+
+	block.height = static_cast<int>(block.lines.size()) * atlas.getLineHeight();
+
+	return block;
+}
+
+int TextLayout::alignX(int anchorX, int width, TextAlign align) {
+
+	switch (align) {
+	case TextAlign::center:
+		return anchorX - width / 2;
+	case TextAlign::right:
+		return anchorX - width;
+	default:
+		return anchorX;
+	}
+}
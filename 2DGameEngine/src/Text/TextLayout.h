@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../Assets/GlyphAtlas.h"
+
+// Which part of the text lines up with its position
+enum class TextAlign {
+	left,
+	center,
+	right
+};
+
+// One line of laid out text: its characters in the string and where it starts from the anchor
+struct TextLine {
+	size_t start = 0;
+	size_t length = 0;
+	int x = 0;
+	int y = 0;
+	int width = 0;
+};
+
+struct TextBlock {
+	std::vector<TextLine> lines;
+	int width = 0;
+	int height = 0;
+};
+
+/// <summary>
+/// Lays text out from the advances and kerning a glyph atlas already holds,
+/// so measuring, aligning and wrapping never render anything. Lines break
+/// at newlines, and at spaces once a line would be wider than maxWidth
+/// </summary>
+class TextLayout {
+
+public:
+
+	// A maxWidth of 0 never wraps. Line positions are relative to the anchor
+	static TextBlock layout(const GlyphAtlas& atlas, const std::string& text, TextAlign align = TextAlign::left, int maxWidth = 0);
+
+	// Left edge of a width wide line aligned to anchorX
+	static int alignX(int anchorX, int width, TextAlign align);
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+
+/// <summary>
+/// Three copies of T shared by one writer and one reader thread. The writer
+/// fills its slot and publishes it, the reader takes the newest published
+/// slot. Neither side ever waits for the other, a slot the reader never
+/// took is simply written over
+/// </summary>
+template <typename T>
+class TripleBuffer {
+
+private:
+
+	// Set in middle while it holds a slot the reader has not taken yet
+	static const int FRESH = 4;
+	static const int INDEX_MASK = 3;
+
+	T slots[3];
+
+	// Only touched by the writer and the reader respectively
+	int writeIndex = 0;
+	int readIndex = 1;
+
+	// The slot passed between the two
+	std::atomic<int> middle{ 2 };
+
+public:
+
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	T& getWriteSlot() {
+		return slots[writeIndex];
+	}
+
+	// Hands the write slot to the reader and carries on in the one it had not taken
+	void publish() {
+		writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// Takes the newest published slot. False when nothing was published since the last call
+	bool acquire() {
+
+		if ((middle.load(std::memory_order_acquire) & FRESH) == 0) {
+			return false;
+		}
+
+		readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+
+		return true;
+	}
+
+	T& getReadSlot() {
+		return slots[readIndex];
+	}
+};
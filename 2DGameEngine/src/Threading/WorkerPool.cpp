@@ -0,0 +1,110 @@
+#include "WorkerPool.h"
+#include "../Logger/Logger.h"
+
+WorkerPool::WorkerPool(int workerCount) {
+
+	if (workerCount < 0) {
+		workerCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+	}
+
+	for (int i = 0; i < workerCount; i++) {
+		workers.emplace_back(&WorkerPool::workerLoop, this);
+	}
+
+	Logger::Log("WorkerPool created with " + std::to_string(workers.size()) + " workers");
+}
+
+WorkerPool::~WorkerPool() {
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+
+	workAvailable.notify_all();
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+int WorkerPool::getThreadCount() const {
+	return static_cast<int>(workers.size()) + 1;
+}
+
+void WorkerPool::runJobs(const std::function<void(int)>& job) {
+
+	for (int index = nextJob++; index < jobCount; index = nextJob++) {
+
+		job(index);
+
+		if (--remainingJobs == 0) {
+			std::lock_guard<std::mutex> lock(mutex);
+			workDone.notify_all();
+		}
+	}
+}
+
+void WorkerPool::workerLoop() {
+
+	unsigned int seenGeneration = 0;
+
+	while (true) {
+
+		const std::function<void(int)>* currentJob;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			workAvailable.wait(lock, [&] {
+				return isStopping || (generation != seenGeneration && remainingJobs > 0);
+			});
+
+			if (isStopping) {
+				return;
+			}
+
+			// Joining is only possible while run is waiting for us, so the job stays alive
+			seenGeneration = generation;
+			currentJob = job;
+			activeWorkers++;
+		}
+
+		runJobs(*currentJob);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeWorkers--;
+			workDone.notify_all();
+		}
+	}
+}
+
+void WorkerPool::run(int jobCount, const std::function<void(int job)>& job) {
+
+	if (workers.empty() || jobCount <= 1) {
+		for (int i = 0; i < jobCount; i++) {
+			job(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		this->jobCount = jobCount;
+		nextJob = 0;
+		remainingJobs = jobCount;
+		generation++;
+	}
+
+	workAvailable.notify_all();
+
+	runJobs(job);
+
+	// Wait for the jobs other threads took, and for those threads to let go of the job
+	std::unique_lock<std::mutex> lock(mutex);
+	workDone.wait(lock, [&] {
+		return remainingJobs == 0 && activeWorkers == 0;
+	});
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// A fixed set of worker threads that run numbered jobs. The thread calling
+/// run takes jobs as well, and run only returns once every job is done
+/// </summary>
+class WorkerPool {
+
+private:
+
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable workAvailable;
+	std::condition_variable workDone;
+
+	const std::function<void(int)>* job = nullptr;
+	int jobCount = 0;
+	std::atomic<int> nextJob{ 0 };
+	std::atomic<int> remainingJobs{ 0 };
+	int activeWorkers = 0;
+	unsigned int generation = 0;
+	bool isStopping = false;
+
+	void workerLoop();
+	void runJobs(const std::function<void(int)>& job);
+
+public:
+
+	// Defaults to one worker per hardware thread, not counting the calling thread
+	WorkerPool(int workerCount = -1);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// Number of threads that take jobs, including the calling thread
+	int getThreadCount() const;
+
+	void run(int jobCount, const std::function<void(int job)>& job);
+};
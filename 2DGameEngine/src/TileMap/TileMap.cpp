@@ -0,0 +1,94 @@
+#include "TileMap.h"
+#include <algorithm>
+
+TileMap::TileMap(const std::string& tilesetAssetID, int columns, int rows, int tileSize, int chunkSize) :
+	tilesetAssetID(tilesetAssetID),
+	columns(std::max(columns, 0)),
+	rows(std::max(rows, 0)),
+	tileSize(std::max(tileSize, 1)),
+	chunkSize(std::max(chunkSize, 1)) {
+
+	// The last chunks may stick out past the map, those tiles stay empty
+	chunkColumns = (this->columns + this->chunkSize - 1) / this->chunkSize;
+	chunkRows = (this->rows + this->chunkSize - 1) / this->chunkSize;
+	tiles.assign(static_cast<size_t>(chunkColumns) * chunkRows * this->chunkSize * this->chunkSize, EMPTY_TILE);
+}
+
+int TileMap::getIndex(int column, int row) const {
+
+	const int chunk = (row / chunkSize) * chunkColumns + column / chunkSize;
+	const int tile = (row % chunkSize) * chunkSize + column % chunkSize;
+
+	return chunk * chunkSize * chunkSize + tile;
+}
+
+void TileMap::setTile(int column, int row, int tile) {
+
+	if (column < 0 || column >= columns || row < 0 || row >= rows) {
+		return;
+	}
+
+	tiles[getIndex(column, row)] = static_cast<int16_t>(tile);
+}
+
+int TileMap::getTile(int column, int row) const {
+
+	if (column < 0 || column >= columns || row < 0 || row >= rows) {
+		return EMPTY_TILE;
+	}
+
+	return tiles[getIndex(column, row)];
+}
+
+void TileMap::fillWithTileset(int tilesetColumns, int tilesetRows) {
+
+	if (tilesetColumns <= 0 || tilesetRows <= 0) {
+		return;
+	}
+
+	for (int row = 0; row < rows; row++) {
+		for (int column = 0; column < columns; column++) {
+			setTile(column, row, (row % tilesetRows) * tilesetColumns + column % tilesetColumns);
+		}
+	}
+}
+
+const int16_t* TileMap::getChunk(int chunkColumn, int chunkRow) const {
+	return tiles.data() + static_cast<size_t>(chunkRow * chunkColumns + chunkColumn) * chunkSize * chunkSize;
+}
+
+const std::string& TileMap::getTilesetAssetID() const {
+	return tilesetAssetID;
+}
+
+int TileMap::getColumns() const {
+	return columns;
+}
+
+int TileMap::getRows() const {
+	return rows;
+}
+
+int TileMap::getTileSize() const {
+	return tileSize;
+}
+
+int TileMap::getChunkSize() const {
+	return chunkSize;
+}
+
+int TileMap::getChunkColumns() const {
+	return chunkColumns;
+}
+
+int TileMap::getChunkRows() const {
+	return chunkRows;
+}
+
+int TileMap::getPixelWidth() const {
+	return columns * tileSize;
+}
+
+int TileMap::getPixelHeight() const {
+	return rows * tileSize;
+}
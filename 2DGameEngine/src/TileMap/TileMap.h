@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// The tiles of a level layer, stored chunk by chunk so a square of
+/// chunkSize by chunkSize tiles is one contiguous array. A tile is an
+/// index into the tileset image cut into tileSize squares, left to right
+/// and top to bottom, or EMPTY_TILE. The map is built while the level
+/// loads and only read after that, the renderer caches each chunk
+/// </summary>
+class TileMap {
+
+private:
+
+	std::string tilesetAssetID;
+	int columns = 0;
+	int rows = 0;
+	int tileSize = 0;
+	int chunkSize = 0;
+	int chunkColumns = 0;
+	int chunkRows = 0;
+	std::vector<int16_t> tiles;
+
+	int getIndex(int column, int row) const;
+
+public:
+
+	static constexpr int16_t EMPTY_TILE = -1;
+
+	TileMap(const std::string& tilesetAssetID, int columns, int rows, int tileSize, int chunkSize = 8);
+
+	void setTile(int column, int row, int tile);
+	// EMPTY_TILE outside the map
+	int getTile(int column, int row) const;
+
+	// Lays the whole tileset out as one picture, repeated over the map
+	void fillWithTileset(int tilesetColumns, int tilesetRows);
+
+	// chunkSize * chunkSize tiles, row by row
+	const int16_t* getChunk(int chunkColumn, int chunkRow) const;
+
+	const std::string& getTilesetAssetID() const;
+	int getColumns() const;
+	int getRows() const;
+	int getTileSize() const;
+	int getChunkSize() const;
+	int getChunkColumns() const;
+	int getChunkRows() const;
+	int getPixelWidth() const;
+	int getPixelHeight() const;
+};
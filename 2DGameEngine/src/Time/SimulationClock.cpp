@@ -0,0 +1,15 @@
+#include "SimulationClock.h"
+#include <cmath>
+
+uint64_t SimulationClock::elapsedMicroseconds = 0;
+
+void SimulationClock::advance(float seconds)
+{
+	// Kept in microseconds, whole milliseconds would drift at steps like 1/60 s
+	elapsedMicroseconds += static_cast<uint64_t>(std::llround(seconds * 1000000.0));
+};
+
+uint32_t SimulationClock::getTicks()
+{
+	return static_cast<uint32_t>(elapsedMicroseconds / 1000);
+};
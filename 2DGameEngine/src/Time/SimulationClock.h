@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Time as the simulation sees it, advanced by one fixed step per tick.
+/// Timers read it instead of SDL_GetTicks, so they follow the simulation
+/// however far its ticks drift from the wall clock
+/// </summary>
+class SimulationClock {
+
+private:
+
+	static uint64_t elapsedMicroseconds;
+
+public:
+
+	static void advance(float seconds);
+
+	// Milliseconds simulated so far, a stand-in for SDL_GetTicks
+	static uint32_t getTicks();
+};